@@ -1,14 +1,66 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <deque>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cctype>
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
 // to run this program please first compile it using the following command:
-// g++ MergeSort.cpp -o MergeSort
+// g++ -std=c++17 -O2 -pthread MergeSort.cpp -o MergeSort
+// (a GCC 11+ / recent clang standard library is needed for floating point from_chars / to_chars)
 
 // then run it using the following command:
 // ./MergeSort < in.txt
 
+// Optional flags:
+//   --parallel <threads>   sort with the work-stealing parallel engine (0 = all hardware threads)
+//   --bottomup             sort with the iterative engine that reuses one scratch buffer
+//   --simd                 sort with the AVX2 sorting-network engine (falls back to --bottomup without AVX2)
+//   --adaptive             sort with the natural-run (TimSort style) engine, O(n) on already sorted input
+//   --radix                sort with LSD radix sort on the bits of the doubles
+//   --auto                 radix sort for big inputs, merge sort for small ones
+//   --threads <threads>    threads used by --radix / --auto (default 1, 0 = all hardware threads)
+//   --argsort              print the original (0-based) position of every value instead of the value
+//   --compare              time every in-memory engine on the same input (printed to stderr);
+//                          --parallel / --threads set the threads of the parallel engine (default: all)
+//   --external             sort without loading everything in RAM (sorted runs on disk + k-way merge)
+//   --memory <MB>          memory budget of the external sort (default 1024)
+//   --tmpdir <dir>         where the external sort puts its temporary run files (default: current directory)
+//   --input <file>         read from this file instead of stdin (both are memory-mapped when possible,
+//                          except with --external, which streams them)
+//   --output <file>        write to this file instead of stdout
+//   --binary               input and output are raw little-endian doubles (no count line)
+//   --timing               print the parse, sort and write times to stderr
+//   --bench <maxN>         benchmark every engine on generated inputs of 1K, 10K, ... maxN values (CSV);
+//                          --threads sets the threads of the parallel engine (default: all). The allocation
+//                          columns need the benchmark build (-DMERGESORT_COUNT_ALLOCATIONS, see runBenchmarkSuite)
+//   --scaling <N>          sort N random values with 1, 2, 4, ... threads and print a timing table
+//                          (run it on the target machine: speedups need that many hardware threads)
+
 // This function merges two parts of the array.
 // We're merging the section from `left` to `mid` with the section from `mid + 1` to `right`.
 // The goal here is to combine them in a way that keeps everything in descending order.
@@ -86,47 +138,1960 @@ void mergeSort(vector<double> &arr, int left, int right)
     }
 }
 
-// The main function is where everything starts.
-// It reads in the number of elements and then the elements themselves.
-// After that, it calls `mergeSort` to sort them in descending order and prints them out.
-int main()
+// ---------------------------------------------------------------------------
+// Parallel MergeSort
+// ---------------------------------------------------------------------------
+// The recursive version above only ever uses one core. The parallel engine keeps exactly the same
+// splitting and the same "left wins ties" merge rule, so the output (and the order of equal keys) is
+// identical, but the two recursive calls become tasks that idle threads can steal.
+
+// A small work-stealing thread pool.
+// Every worker owns a deque of tasks: it pushes and pops its own work at the back (newest first, good for
+// cache locality) and, when it runs out, it steals from the front of somebody else's deque (the oldest
+// task, which is usually the biggest chunk of the recursion).
+class WorkStealingPool
 {
-    int N;
-    cin >> N;
+public:
+    // The calling thread also helps while it waits, so we only start threadCount - 1 extra workers.
+    explicit WorkStealingPool(int threadCount)
+    {
+        if (threadCount < 1)
+            threadCount = 1;
+        queues = vector<TaskQueue>(threadCount);
+        for (int i = 1; i < threadCount; i++)
+            workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (thread &worker : workers)
+            worker.join();
+    }
+
+    int size() const { return (int)queues.size(); }
+
+    // Puts a task on the deque of the thread that created it (or queue 0 for outside threads).
+    void submit(function<void()> task)
+    {
+        int owner = currentWorker >= 0 && currentPool == this ? currentWorker : 0;
+        {
+            lock_guard<mutex> lock(queues[owner].lock);
+            queues[owner].tasks.push_back(move(task));
+        }
+        queuedTasks++;
+        wakeUp.notify_one();
+    }
+
+    // Runs one pending task if there is any. Returns false when every deque is empty.
+    bool runPendingTask()
+    {
+        int self = currentWorker >= 0 && currentPool == this ? currentWorker : 0;
+        function<void()> task;
+        if (popOwnTask(self, task) || stealTask(self, task))
+        {
+            queuedTasks--;
+            task();
+            return true;
+        }
+        return false;
+    }
 
-    vector<double> arr(N);
+private:
+    struct TaskQueue
+    {
+        mutex lock;
+        deque<function<void()>> tasks;
+        TaskQueue() {}
+        TaskQueue(const TaskQueue &) {}
+    };
 
-    // Reading the input values
-    for (int i = 0; i < N; i++)
+    bool popOwnTask(int self, function<void()> &task)
     {
-        cin >> arr[i]; // here we are reading the input values
+        lock_guard<mutex> lock(queues[self].lock);
+        if (queues[self].tasks.empty())
+            return false;
+        task = move(queues[self].tasks.back());
+        queues[self].tasks.pop_back();
+        return true;
     }
 
-    // Sort the array using MergeSort
-    mergeSort(arr, 0, N - 1);
+    bool stealTask(int self, function<void()> &task)
+    {
+        int count = (int)queues.size();
+        for (int offset = 1; offset < count; offset++)
+        {
+            TaskQueue &victim = queues[(self + offset) % count];
+            lock_guard<mutex> lock(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
 
-    // Print the sorted array from largest to smallest
-    for (const double &value : arr)
+    void workerLoop(int index)
     {
-        cout << value << endl;
+        currentWorker = index;
+        currentPool = this;
+        while (true)
+        {
+            if (runPendingTask())
+                continue;
+
+            // Nothing to do: sleep until a new task is submitted (the timeout is just a safety net)
+            unique_lock<mutex> lock(sleepMutex);
+            if (stopping)
+                return;
+            wakeUp.wait_for(lock, chrono::milliseconds(1), [this]() { return stopping || queuedTasks > 0; });
+            if (stopping)
+                return;
+        }
     }
 
-    return 0;
+    vector<TaskQueue> queues;
+    vector<thread> workers;
+    atomic<long long> queuedTasks{0};
+    mutex sleepMutex;
+    condition_variable wakeUp;
+    bool stopping = false;
+
+    static thread_local int currentWorker;
+    static thread_local WorkStealingPool *currentPool;
+};
+
+thread_local int WorkStealingPool::currentWorker = -1;
+thread_local WorkStealingPool *WorkStealingPool::currentPool = nullptr;
+
+// A group of forked tasks that we can join on.
+// While waiting, the thread keeps running other tasks instead of blocking, so nested fork/join never deadlocks.
+class TaskGroup
+{
+public:
+    explicit TaskGroup(WorkStealingPool &pool) : pool(pool) {}
+
+    void run(function<void()> task)
+    {
+        pending++;
+        pool.submit([this, task]() {
+            task();
+            pending--;
+        });
+    }
+
+    void wait()
+    {
+        while (pending > 0)
+        {
+            if (!pool.runPendingTask())
+                this_thread::yield();
+        }
+    }
+
+private:
+    WorkStealingPool &pool;
+    atomic<int> pending{0};
+};
+
+// Below this many elements a task is not worth scheduling, we just call the sequential code.
+const int parallelSortGrain = 1 << 14;
+const int parallelMergeGrain = 1 << 15;
+
+// Co-ranking: for the k-th element of the merged output, find how many of those first k elements come
+// from the left run (the rest come from the right run). It is a binary search on the split point, and the
+// "<" below makes equal keys go to the left run first, just like the "<=" in `merge`.
+int coRank(int k, const double *leftRun, int leftSize, const double *rightRun, int rightSize)
+{
+    int low = max(0, k - rightSize);
+    int high = min(k, leftSize);
+    while (low < high)
+    {
+        int i = low + (high - low) / 2;
+        int j = k - i;
+        if (rightRun[j - 1] < leftRun[i])
+            high = i;
+        else
+            low = i + 1;
+    }
+    return low;
 }
 
-/*
- * Time Complexity Explanation:
- *
- * - The MergeSort algorithm works by dividing the array into two halves,
- *   sorting each half recursively, and then merging the sorted halves.
- *
- * - The "divide" step splits the array in half, which takes constant time O(1).
- * - The "conquer" step involves recursively sorting two halves, which takes O(log n) levels of recursion.
- * - The "merge" step, where we combine the two halves, takes linear time O(n) for each level of recursion.
- *
- * - Overall, the time complexity of MergeSort is O(n log n).
- *   This is because we have O(log n) levels of recursion, and at each level, we spend O(n) time to merge.
- *
- * - MergeSort is more efficient than simpler algorithms like Bubble Sort (O(n^2)),
- *   especially for large datasets, because of its logarithmic splitting.
+// Sequential merge of two sorted runs into `output` (left run wins ties)
+void mergeRuns(const double *leftRun, int leftSize, const double *rightRun, int rightSize, double *output)
+{
+    int i = 0, j = 0, k = 0;
+    while (i < leftSize && j < rightSize)
+    {
+        if (leftRun[i] <= rightRun[j])
+            output[k++] = leftRun[i++];
+        else
+            output[k++] = rightRun[j++];
+    }
+    while (i < leftSize)
+        output[k++] = leftRun[i++];
+    while (j < rightSize)
+        output[k++] = rightRun[j++];
+}
+
+// Merges array[leftIndex..midIndex] and array[midIndex+1..rightIndex] using every thread in the pool.
+// The output is cut into equal slices and every slice finds its own input ranges with `coRank`,
+// so no slice has to wait for any other one. `scratch` has the same size as `array`.
+void parallelMerge(vector<double> &array, vector<double> &scratch, int leftIndex, int midIndex, int rightIndex, WorkStealingPool &pool)
+{
+    int total = rightIndex - leftIndex + 1;
+    if (total <= parallelMergeGrain || pool.size() == 1)
+    {
+        merge(array, leftIndex, midIndex, rightIndex);
+        return;
+    }
+
+    const double *leftRun = &array[leftIndex];
+    const double *rightRun = &array[midIndex + 1];
+    int leftSize = midIndex - leftIndex + 1;
+    int rightSize = rightIndex - midIndex;
+    int slices = min(pool.size() * 4, total / parallelMergeGrain + 1);
+
+    TaskGroup mergeGroup(pool);
+    for (int s = 0; s < slices; s++)
+    {
+        mergeGroup.run([&, s]() {
+            int begin = (int)((long long)total * s / slices);
+            int end = (int)((long long)total * (s + 1) / slices);
+            int leftBegin = coRank(begin, leftRun, leftSize, rightRun, rightSize);
+            int leftEnd = coRank(end, leftRun, leftSize, rightRun, rightSize);
+            mergeRuns(leftRun + leftBegin, leftEnd - leftBegin,
+                      rightRun + (begin - leftBegin), (end - leftEnd) - (begin - leftBegin),
+                      &scratch[leftIndex + begin]);
+        });
+    }
+    mergeGroup.wait();
+
+    // Copy the merged slices back, also in parallel
+    TaskGroup copyGroup(pool);
+    for (int s = 0; s < slices; s++)
+    {
+        copyGroup.run([&, s]() {
+            int begin = leftIndex + (int)((long long)total * s / slices);
+            int end = leftIndex + (int)((long long)total * (s + 1) / slices);
+            copy(scratch.begin() + begin, scratch.begin() + end, array.begin() + begin);
+        });
+    }
+    copyGroup.wait();
+}
+
+// Same recursion as `mergeSort`, but the left half becomes a task that another thread can steal
+// while this thread sorts the right half.
+void parallelMergeSort(vector<double> &arr, vector<double> &scratch, int left, int right, WorkStealingPool &pool)
+{
+    if (right - left + 1 <= parallelSortGrain || pool.size() == 1)
+    {
+        mergeSort(arr, left, right);
+        return;
+    }
+
+    int mid = left + (right - left) / 2;
+
+    TaskGroup halves(pool);
+    halves.run([&]() { parallelMergeSort(arr, scratch, left, mid, pool); });
+    parallelMergeSort(arr, scratch, mid + 1, right, pool);
+    halves.wait();
+
+    parallelMerge(arr, scratch, left, mid, right, pool);
+}
+
+// Entry point of the parallel engine. threadCount = 0 means "use every hardware thread".
+void parallelMergeSort(vector<double> &arr, int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = max(1, (int)thread::hardware_concurrency());
+    if (arr.size() < 2)
+        return;
+
+    WorkStealingPool pool(threadCount);
+    vector<double> scratch(arr.size());
+    parallelMergeSort(arr, scratch, 0, (int)arr.size() - 1, pool);
+}
+
+// Times the parallel engine with 1, 2, 4, ... threads (up to maxThreads, 0 = the number of hardware threads)
+// on the same random input and checks every result against the sequential one. The speedup only means
+// something for thread counts up to the number of hardware threads, which is printed first: past that the
+// threads share cores and the table only shows the scheduling overhead.
+void printScalingTable(int N, int maxThreads)
+{
+    int hardwareThreads = max(1, (int)thread::hardware_concurrency());
+    mt19937_64 generator(12345);
+    uniform_real_distribution<double> distribution(-1e9, 1e9);
+    vector<double> input(N);
+    for (double &value : input)
+        value = distribution(generator);
+
+    vector<double> expected = input;
+    mergeSort(expected, 0, N - 1);
+
+    if (maxThreads <= 0)
+        maxThreads = hardwareThreads;
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    cout << "# hardware threads: " << hardwareThreads << endl;
+    cout << "threads,seconds,speedup,correct" << endl;
+    double baseTime = 0;
+    for (int threads : threadCounts)
+    {
+        vector<double> data = input;
+        auto start = chrono::steady_clock::now();
+        parallelMergeSort(data, threads);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (threads == 1)
+            baseTime = seconds;
+        cout << threads << "," << seconds << "," << baseTime / seconds << "," << (data == expected ? "yes" : "no") << endl;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Bottom-up (iterative) MergeSort with a single scratch buffer
+// ---------------------------------------------------------------------------
+// `merge` above creates two new vectors every time it is called, so a full sort does O(n) heap allocations
+// (one pair per merge) and touches fresh memory all the time. This version allocates one scratch buffer up
+// front and "ping-pongs": every pass merges runs from one buffer into the other and then they swap roles.
+// It also sorts tiny runs with insertion sort first, because for a few dozen elements that is faster
+// than recursing all the way down to single elements.
+
+// Runs shorter than this are sorted with insertion sort. On 400K random doubles 16, 32 and 64 were within
+// noise of each other and 8 was clearly slower, so we kept 32 (a run still fits in a few cache lines).
+const int insertionSortCutoff = 32;
+
+// Stable insertion sort on data[0..size-1]: we only move an element past strictly bigger ones,
+// so equal keys keep their order, just like the "<=" in `merge`.
+void insertionSort(double *data, int size)
+{
+    for (int i = 1; i < size; i++)
+    {
+        double value = data[i];
+        int j = i - 1;
+        while (j >= 0 && data[j] > value)
+        {
+            data[j + 1] = data[j];
+            j--;
+        }
+        data[j + 1] = value;
+    }
+}
+
+void bottomUpMergeSort(vector<double> &arr)
+{
+    int n = (int)arr.size();
+    if (n < 2)
+        return;
+
+    // Step 1: sort every small block with insertion sort
+    for (int start = 0; start < n; start += insertionSortCutoff)
+        insertionSort(&arr[start], min(insertionSortCutoff, n - start));
+
+    if (n <= insertionSortCutoff)
+        return;
+
+    // Step 2: merge runs of width 32, 64, 128, ... alternating between the two buffers
+    vector<double> scratch(n); // the only allocation of the whole sort
+    double *source = arr.data();
+    double *destination = scratch.data();
+
+    for (int width = insertionSortCutoff; width < n; width *= 2)
+    {
+        for (int left = 0; left < n; left += 2 * width)
+        {
+            int mid = min(left + width, n);
+            int right = min(left + 2 * width, n);
+            mergeRuns(source + left, mid - left, source + mid, right - mid, destination + left);
+        }
+        swap(source, destination);
+    }
+
+    // After an odd number of passes the result is in the scratch buffer
+    if (source != arr.data())
+        copy(source, source + n, arr.data());
+}
+
+// ---------------------------------------------------------------------------
+// SIMD (AVX2) MergeSort
+// ---------------------------------------------------------------------------
+// The compare loop in `merge` has a branch that the CPU can't predict on random data. This engine keeps
+// the bottom-up structure above but does the comparisons with min/max instructions on 4 doubles at a time:
+//   - blocks of 16 values are sorted completely inside registers with a sorting network,
+//   - runs are merged 4 values per step with a bitonic merge network.
+// It is picked at runtime: if the CPU has no AVX2 (or this is not an x86 build) we use `bottomUpMergeSort`.
+//
+// A sorting network does not keep equal keys in order. For doubles that only matters for values that compare
+// equal but have different bits (+0.0 / -0.0) and for NaN, so when the input has NaN or both zeros we also take
+// the scalar path. For every other input the result is bit-for-bit the same as `merge` would produce.
+
+// True if the stable scalar path is needed to reproduce `merge` exactly (NaN present, or +0.0 and -0.0 mixed)
+bool needsScalarOrdering(const vector<double> &arr)
+{
+    bool positiveZero = false, negativeZero = false;
+    for (double value : arr)
+    {
+        if (value != value)
+            return true;
+        if (value == 0.0)
+        {
+            if (signbit(value))
+                negativeZero = true;
+            else
+                positiveZero = true;
+        }
+    }
+    return positiveZero && negativeZero;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MERGESORT_HAS_AVX2_PATH 1
+
+bool cpuHasAvx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+// Sorts a bitonic sequence of 4 values (compare at distance 2, then at distance 1)
+__attribute__((target("avx2"))) inline __m256d bitonicClean4(__m256d v)
+{
+    __m256d swapped = _mm256_permute2f128_pd(v, v, 0x01); // v2 v3 v0 v1
+    v = _mm256_blend_pd(_mm256_min_pd(v, swapped), _mm256_max_pd(v, swapped), 0b1100);
+    swapped = _mm256_permute_pd(v, 0b0101); // v1 v0 v3 v2
+    return _mm256_blend_pd(_mm256_min_pd(v, swapped), _mm256_max_pd(v, swapped), 0b1010);
+}
+
+// Merges two sorted vectors: `low` gets the 4 smallest values, `high` the 4 biggest, both sorted
+__attribute__((target("avx2"))) inline void bitonicMerge4(__m256d a, __m256d b, __m256d &low, __m256d &high)
+{
+    b = _mm256_permute4x64_pd(b, 0x1B); // reverse b so that a + b is bitonic
+    low = bitonicClean4(_mm256_min_pd(a, b));
+    high = bitonicClean4(_mm256_max_pd(a, b));
+}
+
+// Sorts 16 values in place using only registers
+__attribute__((target("avx2"))) void sortBlock16(double *block)
+{
+    __m256d r0 = _mm256_loadu_pd(block), r1 = _mm256_loadu_pd(block + 4);
+    __m256d r2 = _mm256_loadu_pd(block + 8), r3 = _mm256_loadu_pd(block + 12);
+
+    // 1. Sorting network for 4 elements applied to every column: (0,1) (2,3) (0,2) (1,3) (1,2)
+    __m256d t;
+    t = _mm256_min_pd(r0, r1), r1 = _mm256_max_pd(r0, r1), r0 = t;
+    t = _mm256_min_pd(r2, r3), r3 = _mm256_max_pd(r2, r3), r2 = t;
+    t = _mm256_min_pd(r0, r2), r2 = _mm256_max_pd(r0, r2), r0 = t;
+    t = _mm256_min_pd(r1, r3), r3 = _mm256_max_pd(r1, r3), r1 = t;
+    t = _mm256_min_pd(r1, r2), r2 = _mm256_max_pd(r1, r2), r1 = t;
+
+    // 2. Transpose, so every sorted column becomes a sorted register
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+    // 3. Merge 4 + 4 twice, then 8 + 8
+    __m256d a0, a1, b0, b1;
+    bitonicMerge4(r0, r1, a0, a1);
+    bitonicMerge4(r2, r3, b0, b1);
+
+    __m256d reversedB0 = _mm256_permute4x64_pd(b1, 0x1B), reversedB1 = _mm256_permute4x64_pd(b0, 0x1B);
+    __m256d low0 = _mm256_min_pd(a0, reversedB0), low1 = _mm256_min_pd(a1, reversedB1);
+    __m256d high0 = _mm256_max_pd(a0, reversedB0), high1 = _mm256_max_pd(a1, reversedB1);
+
+    _mm256_storeu_pd(block, bitonicClean4(_mm256_min_pd(low0, low1)));
+    _mm256_storeu_pd(block + 4, bitonicClean4(_mm256_max_pd(low0, low1)));
+    _mm256_storeu_pd(block + 8, bitonicClean4(_mm256_min_pd(high0, high1)));
+    _mm256_storeu_pd(block + 12, bitonicClean4(_mm256_max_pd(high0, high1)));
+}
+
+// Same job as `mergeRuns`, 4 outputs per step: we keep the 4 biggest values seen so far in `high`, load the
+// next 4 values from the run whose next value is smaller, and the bitonic merge tells us which 4 are final.
+__attribute__((target("avx2"))) void mergeRunsAvx2(const double *leftRun, int leftSize, const double *rightRun, int rightSize, double *output)
+{
+    if (leftSize < 4 || rightSize < 4)
+    {
+        mergeRuns(leftRun, leftSize, rightRun, rightSize, output);
+        return;
+    }
+
+    int i = 4, j = 4, k = 0;
+    __m256d low, high;
+    bitonicMerge4(_mm256_loadu_pd(leftRun), _mm256_loadu_pd(rightRun), low, high);
+    _mm256_storeu_pd(output, low);
+    k += 4;
+
+    while (i + 4 <= leftSize && j + 4 <= rightSize)
+    {
+        __m256d next;
+        if (leftRun[i] <= rightRun[j])
+        {
+            next = _mm256_loadu_pd(leftRun + i);
+            i += 4;
+        }
+        else
+        {
+            next = _mm256_loadu_pd(rightRun + j);
+            j += 4;
+        }
+        bitonicMerge4(next, high, low, high);
+        _mm256_storeu_pd(output + k, low);
+        k += 4;
+    }
+
+    // Finish the 4 values still in `high` against both tails with scalar code, then the normal merge
+    double pending[4];
+    _mm256_storeu_pd(pending, high);
+    int p = 0;
+    while (p < 4)
+    {
+        if (i < leftSize && leftRun[i] < pending[p] && (j >= rightSize || leftRun[i] <= rightRun[j]))
+            output[k++] = leftRun[i++];
+        else if (j < rightSize && rightRun[j] < pending[p])
+            output[k++] = rightRun[j++];
+        else
+            output[k++] = pending[p++];
+    }
+    mergeRuns(leftRun + i, leftSize - i, rightRun + j, rightSize - j, output + k);
+}
+
+// Bottom-up MergeSort where the leaves are sorted 16 at a time and the merges use `mergeRunsAvx2`
+__attribute__((target("avx2"))) void avx2MergeSort(vector<double> &arr)
+{
+    const int blockSize = 16;
+    int n = (int)arr.size();
+
+    int fullBlocks = n / blockSize * blockSize;
+    for (int start = 0; start < fullBlocks; start += blockSize)
+        sortBlock16(&arr[start]);
+    insertionSort(arr.data() + fullBlocks, n - fullBlocks);
+
+    if (n <= blockSize)
+        return;
+
+    vector<double> scratch(n);
+    double *source = arr.data();
+    double *destination = scratch.data();
+
+    for (int width = blockSize; width < n; width *= 2)
+    {
+        for (int left = 0; left < n; left += 2 * width)
+        {
+            int mid = min(left + width, n);
+            int right = min(left + 2 * width, n);
+            mergeRunsAvx2(source + left, mid - left, source + mid, right - mid, destination + left);
+        }
+        swap(source, destination);
+    }
+
+    if (source != arr.data())
+        copy(source, source + n, arr.data());
+}
+#endif
+
+// Entry point of the SIMD engine: picks the AVX2 kernels when the CPU has them, the scalar ones otherwise
+void simdMergeSort(vector<double> &arr)
+{
+#ifdef MERGESORT_HAS_AVX2_PATH
+    if (cpuHasAvx2() && !needsScalarOrdering(arr))
+    {
+        avx2MergeSort(arr);
+        return;
+    }
+#endif
+    bottomUpMergeSort(arr);
+}
+
+// ---------------------------------------------------------------------------
+// Adaptive MergeSort (natural runs, TimSort style)
+// ---------------------------------------------------------------------------
+// Our inputs are usually time series that are already almost sorted, but `mergeSort` still splits them down
+// to single elements. This engine instead walks the array looking for "natural runs":
+//   - an ascending run (a[i] <= a[i+1]) is used as it is,
+//   - a strictly descending run (a[i] > a[i+1]) is reversed (strictly, so equal keys never swap places),
+//   - runs shorter than `minRun` are extended with binary insertion sort.
+// The runs go on a stack and are merged following the TimSort rules, which keep the stack balanced so the total
+// work stays O(n log n). Merges "gallop" (exponential search) when one run keeps winning, so big already
+// ordered blocks are copied in one go. A completely sorted input is a single run: O(n), no merging at all.
+
+const int minimumGallop = 7;
+
+// How many of the first `length` values of `run` are <= key (exponential search, then binary search)
+int gallopRight(double key, const double *run, int length)
+{
+    int bound = 1;
+    while (bound <= length && run[bound - 1] <= key)
+        bound *= 2;
+    int low = bound / 2, high = min(bound, length);
+    return (int)(upper_bound(run + low, run + high, key) - run);
+}
+
+// How many of the first `length` values of `run` are < key
+int gallopLeft(double key, const double *run, int length)
+{
+    int bound = 1;
+    while (bound <= length && run[bound - 1] < key)
+        bound *= 2;
+    int low = bound / 2, high = min(bound, length);
+    return (int)(lower_bound(run + low, run + high, key) - run);
+}
+
+// Computes the minimum run length, a value between 32 and 64 chosen so that n / minRun is a power of two
+// (or a bit less), which makes the final merges balanced.
+int computeMinRun(int n)
+{
+    int extraBit = 0;
+    while (n >= 64)
+    {
+        extraBit |= n & 1;
+        n >>= 1;
+    }
+    return n + extraBit;
+}
+
+// Stable binary insertion sort of data[0..size-1] where the first `sortedPrefix` values are already sorted
+void binaryInsertionSort(double *data, int size, int sortedPrefix)
+{
+    for (int i = max(sortedPrefix, 1); i < size; i++)
+    {
+        double value = data[i];
+        double *position = upper_bound(data, data + i, value); // after equal keys, to stay stable
+        move_backward(position, data + i, data + i + 1);
+        *position = value;
+    }
+}
+
+class AdaptiveMergeSorter
+{
+public:
+    explicit AdaptiveMergeSorter(vector<double> &arr) : arr(arr) {}
+
+    void sort()
+    {
+        int n = (int)arr.size();
+        if (n < 2)
+            return;
+
+        int minRun = computeMinRun(n);
+        int start = 0;
+        while (start < n)
+        {
+            int length = countRunAndMakeAscending(start, n);
+
+            // Short natural run: extend it to minRun elements with insertion sort
+            if (length < minRun)
+            {
+                int forced = min(minRun, n - start);
+                binaryInsertionSort(&arr[start], forced, length);
+                length = forced;
+            }
+
+            runs.push_back({start, length});
+            mergeCollapse();
+            start += length;
+        }
+
+        // Merge whatever is left on the stack, from the top
+        while (runs.size() > 1)
+        {
+            int index = (int)runs.size() - 2;
+            if (index > 0 && runs[index - 1].second < runs[index + 1].second)
+                index--;
+            mergeAt(index);
+        }
+    }
+
+private:
+    // Finds the run starting at `start` and returns its length. Descending runs are reversed in place.
+    int countRunAndMakeAscending(int start, int n)
+    {
+        int end = start + 1;
+        if (end == n)
+            return 1;
+
+        if (arr[end] < arr[start])
+        {
+            while (end < n && arr[end] < arr[end - 1])
+                end++;
+            reverse(arr.begin() + start, arr.begin() + end);
+        }
+        else
+        {
+            while (end < n && arr[end] >= arr[end - 1])
+                end++;
+        }
+        return end - start;
+    }
+
+    // TimSort's stack rules (including the extra check on the third run found by de Gouw et al.):
+    // every run must be longer than the next two together, otherwise we merge.
+    void mergeCollapse()
+    {
+        while (runs.size() > 1)
+        {
+            int index = (int)runs.size() - 2;
+            if ((index > 0 && runs[index - 1].second <= runs[index].second + runs[index + 1].second) ||
+                (index > 1 && runs[index - 2].second <= runs[index - 1].second + runs[index].second))
+            {
+                if (runs[index - 1].second < runs[index + 1].second)
+                    index--;
+                mergeAt(index);
+            }
+            else if (runs[index].second <= runs[index + 1].second)
+            {
+                mergeAt(index);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    // Merges runs[index] and runs[index + 1] (neighbours in the array)
+    void mergeAt(int index)
+    {
+        int base = runs[index].first;
+        int leftLength = runs[index].second;
+        int rightLength = runs[index + 1].second;
+
+        runs[index].second = leftLength + rightLength;
+        runs.erase(runs.begin() + index + 1);
+
+        double *left = &arr[base];
+        double *right = left + leftLength;
+
+        // Values of the left run that are <= right[0] are already in their final place
+        int skip = gallopRight(right[0], left, leftLength);
+        left += skip;
+        leftLength -= skip;
+        if (leftLength == 0)
+            return;
+
+        // Values of the right run that are >= the last left value (and not equal, for stability) are too
+        rightLength = gallopLeft(left[leftLength - 1], right, rightLength);
+        if (rightLength == 0)
+            return;
+
+        mergeLow(left, leftLength, right, rightLength);
+    }
+
+    // Merges left[] and right[] (right comes right after left in memory) from the front,
+    // keeping a copy of the left run in `temporary`. Left wins ties, like `merge`.
+    void mergeLow(double *destination, int leftLength, const double *right, int rightLength)
+    {
+        if ((int)temporary.size() < leftLength)
+            temporary.resize(max<size_t>(leftLength, temporary.size() * 2));
+        copy(destination, destination + leftLength, temporary.begin());
+
+        const double *left = temporary.data();
+        int i = 0, j = 0;
+        while (i < leftLength && j < rightLength)
+        {
+            // Normal one-by-one merge, counting how many times in a row the same side wins
+            int leftWins = 0, rightWins = 0;
+            while (i < leftLength && j < rightLength && max(leftWins, rightWins) < minimumGallop)
+            {
+                if (right[j] < left[i])
+                {
+                    *destination++ = right[j++];
+                    rightWins++, leftWins = 0;
+                }
+                else
+                {
+                    *destination++ = left[i++];
+                    leftWins++, rightWins = 0;
+                }
+            }
+
+            // Galloping mode: copy whole blocks while one side keeps winning
+            while (i < leftLength && j < rightLength)
+            {
+                int count = gallopRight(right[j], left + i, leftLength - i);
+                destination = copy(left + i, left + i + count, destination);
+                i += count;
+                if (i == leftLength)
+                    break;
+
+                int countRight = gallopLeft(left[i], right + j, rightLength - j);
+                destination = copy(right + j, right + j + countRight, destination);
+                j += countRight;
+
+                if (count < minimumGallop && countRight < minimumGallop)
+                    break; // galloping is not paying off, go back to one-by-one
+            }
+        }
+
+        // Leftovers of the right run are already in place; leftovers of the left run must be copied back
+        copy(left + i, left + leftLength, destination);
+    }
+
+    vector<double> &arr;
+    vector<pair<int, int>> runs; // (start, length) of every pending run
+    vector<double> temporary;    // grows up to the size of the biggest left run we merge
+};
+
+void adaptiveMergeSort(vector<double> &arr)
+{
+    AdaptiveMergeSorter sorter(arr);
+    sorter.sort();
+}
+
+// ---------------------------------------------------------------------------
+// Radix sort (LSD) for doubles and for records with a double key
+// ---------------------------------------------------------------------------
+// For 8-byte keys we don't need comparisons at all: we look at the key 8 bits at a time, from the least
+// significant byte to the most significant one, and every pass is a stable counting sort (histogram,
+// prefix sums, scatter). 8 passes of O(n) each, no matter how the data looks.
+//
+// The bits of a double don't sort like the number, so first we map them to an unsigned integer that does:
+// for positive numbers we flip the sign bit, for negative numbers we flip every bit. This is the IEEE-754
+// "totalOrder", so -0.0 goes before +0.0 and NaNs go to the ends (merge sort keeps those in input order).
+//
+// The API is a template over the record type, so the same code sorts plain doubles, (key, index) pairs
+// for an argsort, or any payload that has a double key.
+
+inline unsigned long long orderedBits(double key)
+{
+    unsigned long long bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+}
+
+// A value with the position it had in the input, used for argsort and payload sorting
+struct KeyIndex
+{
+    double key;
+    int index;
+};
+
+// How many records ahead the scatter prefetches the destination slot
+const size_t scatterPrefetchDistance = 16;
+
+template <typename Record, typename GetKey>
+void radixSortRecords(vector<Record> &records, GetKey getKey, int threadCount = 1)
+{
+    const int digitBits = 8;
+    const int buckets = 1 << digitBits;
+    const int passes = 64 / digitBits;
+    size_t n = records.size();
+    if (n < 2)
+        return;
+
+    if (threadCount <= 0)
+        threadCount = max(1, (int)thread::hardware_concurrency());
+    int chunks = (int)min<size_t>(threadCount, max<size_t>(n / 65536, 1));
+    WorkStealingPool pool(chunks);
+
+    // One read of the data gives the histograms of all 8 digits. A pass where every key has the same digit
+    // would not move anything, so we skip it (very common: sign and exponent bytes of similar values).
+    vector<size_t> globalCount(passes * buckets, 0);
+    for (const Record &record : records)
+    {
+        unsigned long long bits = orderedBits(getKey(record));
+        for (int pass = 0; pass < passes; pass++)
+            globalCount[pass * buckets + ((bits >> (pass * digitBits)) & (buckets - 1))]++;
+    }
+
+    vector<Record> buffer(n);
+    Record *source = records.data();
+    Record *destination = buffer.data();
+    vector<size_t> chunkOffsets((size_t)chunks * buckets);
+
+    for (int pass = 0; pass < passes; pass++)
+    {
+        int shift = pass * digitBits;
+        bool trivial = false;
+        for (int digit = 0; digit < buckets; digit++)
+            if (globalCount[pass * buckets + digit] == n)
+                trivial = true;
+        if (trivial)
+            continue;
+
+        // 1. Every chunk counts its own digits (in parallel)
+        TaskGroup counting(pool);
+        for (int c = 0; c < chunks; c++)
+        {
+            counting.run([&, c]() {
+                size_t *count = &chunkOffsets[(size_t)c * buckets];
+                fill(count, count + buckets, 0);
+                size_t begin = n * c / chunks, end = n * (c + 1) / chunks;
+                for (size_t i = begin; i < end; i++)
+                    count[(orderedBits(getKey(source[i])) >> shift) & (buckets - 1)]++;
+            });
+        }
+        counting.wait();
+
+        // 2. Prefix sums: digit by digit, and inside a digit chunk by chunk, so the scatter stays stable
+        size_t position = 0;
+        for (int digit = 0; digit < buckets; digit++)
+        {
+            for (int c = 0; c < chunks; c++)
+            {
+                size_t count = chunkOffsets[(size_t)c * buckets + digit];
+                chunkOffsets[(size_t)c * buckets + digit] = position;
+                position += count;
+            }
+        }
+
+        // 3. Every chunk writes its records to their final place for this pass (in parallel, no overlap)
+        TaskGroup scatter(pool);
+        for (int c = 0; c < chunks; c++)
+        {
+            scatter.run([&, c]() {
+                size_t *offset = &chunkOffsets[(size_t)c * buckets];
+                size_t begin = n * c / chunks, end = n * (c + 1) / chunks;
+                for (size_t i = begin; i < end; i++)
+                {
+                    // The reads are sequential (the hardware prefetcher sees them), the writes jump between
+                    // 256 buckets. So we ask for the current slot of the bucket of the record a few iterations
+                    // ahead: that record lands at most scatterPrefetchDistance slots after it.
+                    if (i + scatterPrefetchDistance < end)
+                    {
+                        int ahead = (orderedBits(getKey(source[i + scatterPrefetchDistance])) >> shift) & (buckets - 1);
+                        __builtin_prefetch(&destination[offset[ahead]], 1);
+                    }
+                    destination[offset[(orderedBits(getKey(source[i])) >> shift) & (buckets - 1)]++] = source[i];
+                }
+            });
+        }
+        scatter.wait();
+
+        swap(source, destination);
+    }
+
+    if (source != records.data())
+        copy(source, source + n, records.data());
+}
+
+void radixSort(vector<double> &arr, int threadCount = 1)
+{
+    radixSortRecords(arr, [](double value) { return value; }, threadCount);
+}
+
+// Returns the input positions in sorted order (ties keep their input order because LSD radix is stable)
+vector<int> argsort(const vector<double> &arr, int threadCount = 1)
+{
+    vector<KeyIndex> pairs(arr.size());
+    for (size_t i = 0; i < arr.size(); i++)
+        pairs[i] = {arr[i], (int)i};
+    radixSortRecords(pairs, [](const KeyIndex &pair) { return pair.key; }, threadCount);
+
+    vector<int> order(arr.size());
+    for (size_t i = 0; i < pairs.size(); i++)
+        order[i] = pairs[i].index;
+    return order;
+}
+
+// Below this size the fixed cost of 8 passes (and the 2 KB of counters per pass) is more than what radix
+// saves; on random doubles the two crossed over between 2K and 4K values.
+const int radixSortThreshold = 4096;
+
+// Picks radix sort for big inputs and merge sort for small ones. Radix orders -0.0/+0.0 and NaN differently
+// from merge sort, so inputs with those values stay on merge sort to keep the output the same.
+void autoSort(vector<double> &arr, int threadCount)
+{
+    if ((int)arr.size() >= radixSortThreshold && !needsScalarOrdering(arr))
+        radixSort(arr, threadCount);
+    else
+        bottomUpMergeSort(arr);
+}
+
+// Sorts copies of the same input with every in-memory engine and prints the times to stderr,
+// so the normal sorted output on stdout stays the same. threadCount is used by the parallel engine
+// (0 = all hardware threads).
+void compareEngines(const vector<double> &input, int threadCount)
+{
+    vector<pair<string, function<void(vector<double> &)>>> engines = {
+        {"recursive mergeSort", [](vector<double> &data) { mergeSort(data, 0, (int)data.size() - 1); }},
+        {"parallel mergeSort", [threadCount](vector<double> &data) { parallelMergeSort(data, threadCount); }},
+        {"bottom-up mergeSort", [](vector<double> &data) { bottomUpMergeSort(data); }},
+        {"simd mergeSort", [](vector<double> &data) { simdMergeSort(data); }},
+        {"adaptive mergeSort", [](vector<double> &data) { adaptiveMergeSort(data); }},
+        {"radix sort", [](vector<double> &data) { radixSort(data); }},
+    };
+
+    vector<double> expected;
+    for (auto &engine : engines)
+    {
+        vector<double> data = input;
+        auto start = chrono::steady_clock::now();
+        engine.second(data);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        // Compare the bits, not the values, so NaN and -0.0 must also end up in the same place
+        if (expected.empty())
+            expected = data;
+        bool same = data.size() == expected.size() && memcmp(data.data(), expected.data(), data.size() * sizeof(double)) == 0;
+        cerr << engine.first << ": " << seconds << " s" << (same ? "" : " (DIFFERENT RESULT)") << endl;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fast input and output
+// ---------------------------------------------------------------------------
+// With millions of values, `cin >> value` and `cout << value << endl` (one flush per line) take longer than
+// the sort. Instead we map the whole input file into memory, parse it with `from_chars` (no locale, no
+// stream state, no copies), and build the output in a big buffer with `to_chars` that is written in large
+// blocks and flushed once at the end.
+// There is also a raw binary format: the file is just the doubles, 8 bytes each, little-endian, no count.
+
+// The whole content of a file (or of stdin) in memory. Regular files are mapped with mmap, anything else
+// (a pipe, a terminal) is read into a buffer.
+class MappedInput
+{
+public:
+    // path == "" means stdin
+    explicit MappedInput(const string &path)
+    {
+        int descriptor = path.empty() ? 0 : open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            cerr << "Error: could not open " << path << endl;
+            exit(1);
+        }
+
+        struct stat information;
+        if (fstat(descriptor, &information) == 0 && S_ISREG(information.st_mode) && information.st_size > 0)
+        {
+            size = (size_t)information.st_size;
+            void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (address != MAP_FAILED)
+            {
+                madvise(address, size, MADV_SEQUENTIAL);
+                mapping = address;
+                data = (const char *)address;
+            }
+        }
+
+        if (!mapping)
+        {
+            char chunk[1 << 16];
+            ssize_t got;
+            while ((got = read(descriptor, chunk, sizeof(chunk))) > 0)
+                copyOfInput.insert(copyOfInput.end(), chunk, chunk + got);
+            data = copyOfInput.data();
+            size = copyOfInput.size();
+        }
+
+        if (!path.empty())
+            close(descriptor);
+    }
+
+    ~MappedInput()
+    {
+        if (mapping)
+            munmap(mapping, size);
+    }
+
+    const char *data = nullptr;
+    size_t size = 0;
+
+private:
+    void *mapping = nullptr;
+    vector<char> copyOfInput;
+};
+
+// Parses numbers one after the other from a text buffer
+class NumberParser
+{
+public:
+    NumberParser(const char *begin, const char *end) : current(begin), end(end) {}
+
+    template <typename Number>
+    bool next(Number &value)
+    {
+        while (current < end && (isspace((unsigned char)*current) || *current == '+'))
+            current++;
+        if (current == end)
+            return false;
+        from_chars_result result = from_chars(current, end, value);
+        if (result.ec != errc())
+            return false;
+        current = result.ptr;
+        return true;
+    }
+
+private:
+    const char *current;
+    const char *end;
+};
+
+// Reads the normal text format: N followed by N values
+vector<double> readTextInput(const MappedInput &input)
+{
+    NumberParser parser(input.data, input.data + input.size);
+    int N = 0;
+    parser.next(N);
+
+    vector<double> arr(max(N, 0));
+    for (double &value : arr)
+        if (!parser.next(value))
+            break;
+    return arr;
+}
+
+inline bool hostIsLittleEndian()
+{
+    const unsigned short probe = 1;
+    unsigned char firstByte;
+    memcpy(&firstByte, &probe, 1);
+    return firstByte == 1;
+}
+
+inline double swapBytes(double value)
+{
+    unsigned char bytes[sizeof(double)];
+    memcpy(bytes, &value, sizeof(double));
+    reverse(bytes, bytes + sizeof(double));
+    memcpy(&value, bytes, sizeof(double));
+    return value;
+}
+
+// Reads the binary format: the mapped bytes are already the doubles, so this is a single copy
+vector<double> readBinaryInput(const MappedInput &input)
+{
+    vector<double> arr(input.size / sizeof(double));
+    if (!arr.empty())
+        memcpy(arr.data(), input.data, arr.size() * sizeof(double));
+    if (!hostIsLittleEndian())
+        for (double &value : arr)
+            value = swapBytes(value);
+    return arr;
+}
+
+// Collects the output in a 1 MB buffer and hands it to the OS in big blocks
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(FILE *file) : file(file), buffer(1 << 20) {}
+
+    ~BufferedWriter() { flush(); }
+
+    // Same text as `cout << value` (printf "%g", 6 significant digits)
+    void writeLine(double value)
+    {
+        reserve(64);
+        to_chars_result result = to_chars(&buffer[used], &buffer[used] + 63, value, chars_format::general, 6);
+        used = result.ptr - buffer.data();
+        buffer[used++] = '\n';
+    }
+
+    void writeLine(int value)
+    {
+        reserve(16);
+        to_chars_result result = to_chars(&buffer[used], &buffer[used] + 15, value);
+        used = result.ptr - buffer.data();
+        buffer[used++] = '\n';
+    }
+
+    void writeBinary(double value)
+    {
+        reserve(sizeof(double));
+        if (!hostIsLittleEndian())
+            value = swapBytes(value);
+        memcpy(&buffer[used], &value, sizeof(double));
+        used += sizeof(double);
+    }
+
+    void flush()
+    {
+        if (used > 0 && fwrite(buffer.data(), 1, used, file) != used)
+        {
+            cerr << "Error: could not write the output" << endl;
+            exit(1);
+        }
+        used = 0;
+        fflush(file);
+    }
+
+private:
+    void reserve(size_t bytes)
+    {
+        if (used + bytes > buffer.size() && used > 0 && fwrite(buffer.data(), 1, used, file) != used)
+        {
+            cerr << "Error: could not write the output" << endl;
+            exit(1);
+        }
+        if (used + bytes > buffer.size())
+            used = 0;
+    }
+
+    FILE *file;
+    vector<char> buffer;
+    size_t used = 0;
+};
+
+// ---------------------------------------------------------------------------
+// External-memory MergeSort (for inputs that do not fit in RAM)
+// ---------------------------------------------------------------------------
+// The normal program keeps all N values in one vector. The external mode never does that:
+//   1. It reads the input in RAM-sized pieces ("runs"), sorts each run with the normal `mergeSort`
+//      and writes it to a temporary binary file.
+//   2. It merges all the sorted runs at once with a loser tree (a k-way tournament), reading and writing
+//      big sequential blocks so the disk is used at full speed.
+// If there are more runs than we can give a decent read buffer to, it merges groups of runs into bigger
+// runs first (extra merge passes), so the memory budget is always respected.
+
+// Reads a run file (raw doubles) through a large buffer.
+class RunReader
+{
+public:
+    RunReader(const string &path, size_t bufferElements) : buffer(max<size_t>(bufferElements, 1))
+    {
+        file = fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            cerr << "Error: could not open run file " << path << endl;
+            exit(1);
+        }
+    }
+
+    ~RunReader() { fclose(file); }
+
+    // Puts the next value of the run in `value`; returns false when the run is finished
+    bool next(double &value)
+    {
+        if (position == filled)
+        {
+            filled = fread(buffer.data(), sizeof(double), buffer.size(), file);
+            position = 0;
+            if (filled == 0)
+                return false;
+        }
+        value = buffer[position++];
+        return true;
+    }
+
+private:
+    FILE *file;
+    vector<double> buffer;
+    size_t position = 0, filled = 0;
+};
+
+// Collects values in a buffer and writes them with one big fwrite when the buffer is full.
+class RunWriter
+{
+public:
+    RunWriter(const string &path, size_t bufferElements) : buffer(max<size_t>(bufferElements, 1))
+    {
+        file = fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            cerr << "Error: could not create run file " << path << endl;
+            exit(1);
+        }
+    }
+
+    ~RunWriter()
+    {
+        flush();
+        fclose(file);
+    }
+
+    void write(double value)
+    {
+        buffer[filled++] = value;
+        if (filled == buffer.size())
+            flush();
+    }
+
+    void flush()
+    {
+        if (filled > 0 && fwrite(buffer.data(), sizeof(double), filled, file) != filled)
+        {
+            cerr << "Error: could not write run file (disk full?)" << endl;
+            exit(1);
+        }
+        filled = 0;
+    }
+
+private:
+    FILE *file;
+    vector<double> buffer;
+    size_t filled = 0;
+};
+
+// Loser tree for a k-way merge.
+// Every internal node remembers the run that LOST the match played there, and tree[0] keeps the overall
+// winner. After the winner's run gives us its next value we only replay the matches on the path from that
+// leaf to the root, so each output value costs about log2(k) comparisons.
+class LoserTree
+{
+public:
+    explicit LoserTree(vector<RunReader *> &runs) : runs(runs), k((int)runs.size()), tree(max(k, 1)), current(k), finished(k)
+    {
+        for (int i = 0; i < k; i++)
+            finished[i] = !runs[i]->next(current[i]);
+        if (k > 0)
+            tree[0] = build(1);
+    }
+
+    // Gets the smallest remaining value; returns false when every run is finished
+    bool pop(double &value)
+    {
+        if (k == 0)
+            return false;
+        int winner = tree[0];
+        if (finished[winner])
+            return false;
+        value = current[winner];
+
+        // Refill the winner's leaf and replay its path up to the root
+        finished[winner] = !runs[winner]->next(current[winner]);
+        for (int node = (winner + k) / 2; node >= 1; node /= 2)
+        {
+            if (beats(tree[node], winner))
+                swap(tree[node], winner);
+        }
+        tree[0] = winner;
+        return true;
+    }
+
+private:
+    // Decides a match: smaller value wins, and on a tie the run that came earlier in the input wins,
+    // which keeps the sort stable (same idea as the "<=" in `merge`).
+    bool beats(int a, int b) const
+    {
+        if (finished[a] != finished[b])
+            return finished[b]; // a finished run loses against everything
+        if (finished[a])
+            return a < b;
+        if (current[a] < current[b])
+            return true;
+        if (current[b] < current[a])
+            return false;
+        return a < b;
+    }
+
+    // Plays the initial tournament; leaves are the nodes k..2k-1 (leaf k + i is run i)
+    int build(int node)
+    {
+        if (node >= k)
+            return node - k;
+        int a = build(2 * node);
+        int b = build(2 * node + 1);
+        if (beats(a, b))
+        {
+            tree[node] = b;
+            return a;
+        }
+        tree[node] = a;
+        return b;
+    }
+
+    vector<RunReader *> &runs;
+    int k;
+    vector<int> tree;
+    vector<double> current;
+    vector<char> finished;
+};
+
+// Settings of the external sort
+struct ExternalSortOptions
+{
+    size_t memoryBudgetBytes = 1024ull * 1024 * 1024; // --memory (in MB), 1 GB by default
+    string temporaryDirectory = ".";                   // --tmpdir
+};
+
+// Merges the given run files into `emit`, respecting the memory budget for the read buffers.
+void mergeRunFiles(const vector<string> &paths, size_t memoryBudgetBytes, const function<void(double)> &emit)
+{
+    // Every run and the output get an equal share of the budget
+    size_t bufferElements = memoryBudgetBytes / sizeof(double) / (paths.size() + 1);
+
+    vector<RunReader *> readers;
+    for (const string &path : paths)
+        readers.push_back(new RunReader(path, bufferElements));
+
+    LoserTree tree(readers);
+    double value;
+    while (tree.pop(value))
+        emit(value);
+
+    for (RunReader *reader : readers)
+        delete reader;
+}
+
+// Sorts the values that `next` gives (until it returns false) and writes them to `out`, one per line or as
+// raw doubles with `binary`, using at most about options.memoryBudgetBytes of RAM for the data.
+// sizeHint is the number of values when it is known up front (-1 if not), to size the first run exactly.
+void externalMergeSort(const function<bool(double &)> &next, BufferedWriter &out, bool binary, const ExternalSortOptions &options, long long sizeHint = -1)
+{
+    // `mergeSort` needs the run plus about the same again for its temporary vectors,
+    // and it works with int indices, so a run can't be bigger than INT_MAX elements.
+    size_t runCapacity = max<size_t>(options.memoryBudgetBytes / (2 * sizeof(double)), 1024);
+    runCapacity = min<size_t>(runCapacity, (size_t)numeric_limits<int>::max());
+
+    // We want read buffers of at least 1 MB per run while merging; with more runs than that we need
+    // extra merge passes.
+    const size_t minimumBufferBytes = 1 << 20;
+    size_t maxFanIn = max<size_t>(options.memoryBudgetBytes / minimumBufferBytes - 1, 2);
+
+    string prefix = options.temporaryDirectory + "/mergesort_run_" + to_string((long long)chrono::steady_clock::now().time_since_epoch().count()) + "_";
+    int nextRunId = 0;
+    vector<string> runPaths;
+
+    // Phase 1: create sorted runs
+    vector<double> run;
+    if (sizeHint >= 0)
+        run.reserve((size_t)min<long long>(sizeHint, (long long)runCapacity));
+    bool more = true;
+    while (more)
+    {
+        run.clear();
+        double value;
+        while (run.size() < runCapacity && (more = next(value)))
+            run.push_back(value);
+        if (run.empty())
+            break;
+
+        mergeSort(run, 0, (int)run.size() - 1);
+
+        string path = prefix + to_string(nextRunId++) + ".bin";
+        RunWriter writer(path, 1 << 16);
+        for (double sortedValue : run)
+            writer.write(sortedValue);
+        runPaths.push_back(path);
+    }
+    vector<double>().swap(run); // give the run memory back before merging
+
+    // Phase 2 (only for huge inputs): merge groups of runs until one final merge is enough
+    while (runPaths.size() > maxFanIn)
+    {
+        vector<string> mergedPaths;
+        for (size_t start = 0; start < runPaths.size(); start += maxFanIn)
+        {
+            vector<string> group(runPaths.begin() + start, runPaths.begin() + min(runPaths.size(), start + maxFanIn));
+            string path = prefix + to_string(nextRunId++) + ".bin";
+            {
+                RunWriter writer(path, options.memoryBudgetBytes / sizeof(double) / (group.size() + 1));
+                mergeRunFiles(group, options.memoryBudgetBytes, [&](double value) { writer.write(value); });
+            }
+            for (const string &oldPath : group)
+                remove(oldPath.c_str());
+            mergedPaths.push_back(path);
+        }
+        runPaths = mergedPaths;
+    }
+
+    // Phase 3: final k-way merge straight to the output
+    mergeRunFiles(runPaths, options.memoryBudgetBytes, [&](double value)
+                  {
+                      if (binary)
+                          out.writeBinary(value);
+                      else
+                          out.writeLine(value);
+                  });
+    out.flush();
+
+    for (const string &path : runPaths)
+        remove(path.c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark suite
+// ---------------------------------------------------------------------------
+// Runs every in-memory engine (plus std::sort and std::stable_sort as a reference) over generated inputs of
+// different shapes and sizes and prints one CSV line per (engine, distribution, size):
+//   ns_per_element   sort time divided by n (average of several runs for small n)
+//   allocations      calls to operator new during one sort
+//   peak_heap_bytes  most heap memory alive at the same time during one sort (on top of the input)
+//                    (these two need a build with -DMERGESORT_COUNT_ALLOCATIONS, see below; "n/a" otherwise)
+//   max_rss_kb       the process' peak resident memory so far (from getrusage, it never goes down)
+//   sorted           whether the non-NaN values came out in order. The comparison engines have no defined
+//                    order with NaN (NaN <= x is always false), so "no" on the nan input is expected for them.
+
+// Global allocation counters. Replacing the global operator new / delete costs every allocation of the
+// program a header and three shared atomics (about 5-10% on a sort, and contention between the threads of
+// the parallel engine), so it is only compiled into a separate benchmark build:
+//   g++ -std=c++17 -O2 -pthread -DMERGESORT_COUNT_ALLOCATIONS MergeSort.cpp -o MergeSortBench
+// Every allocation then keeps its size in a small header so `delete` can subtract it.
+atomic<long long> allocationCount{0};
+atomic<long long> liveHeapBytes{0};
+atomic<long long> peakHeapBytes{0};
+
+#ifdef MERGESORT_COUNT_ALLOCATIONS
+const bool countingAllocations = true;
+
+void *countedAllocate(size_t size)
+{
+    const size_t header = 16; // keeps the returned pointer 16-byte aligned, like malloc
+    char *block = (char *)malloc(size + header);
+    if (!block)
+        throw bad_alloc();
+    memcpy(block, &size, sizeof(size));
+
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    long long live = liveHeapBytes.fetch_add((long long)size, memory_order_relaxed) + (long long)size;
+    long long peak = peakHeapBytes.load(memory_order_relaxed);
+    while (live > peak && !peakHeapBytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+    {
+    }
+    return block + header;
+}
+
+void countedFree(void *pointer)
+{
+    if (!pointer)
+        return;
+    char *block = (char *)pointer - 16;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    liveHeapBytes.fetch_sub((long long)size, memory_order_relaxed);
+    free(block);
+}
+
+void *operator new(size_t size) { return countedAllocate(size); }
+void *operator new[](size_t size) { return countedAllocate(size); }
+void operator delete(void *pointer) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer) noexcept { countedFree(pointer); }
+void operator delete(void *pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { countedFree(pointer); }
+
+// std::stable_sort asks for its buffer with the nothrow versions, so they need the same header
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+    try
+    {
+        return countedAllocate(size);
+    }
+    catch (const bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](size_t size, const nothrow_t &tag) noexcept { return operator new(size, tag); }
+void operator delete(void *pointer, const nothrow_t &) noexcept { countedFree(pointer); }
+void operator delete[](void *pointer, const nothrow_t &) noexcept { countedFree(pointer); }
+#else
+const bool countingAllocations = false;
+#endif
+
+long long maxResidentKilobytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // macOS reports bytes
+#else
+    return usage.ru_maxrss; // Linux reports kilobytes
+#endif
+}
+
+// Builds an input of size n with the given shape
+vector<double> generateDistribution(const string &name, size_t n, mt19937_64 &generator)
+{
+    vector<double> data(n);
+    uniform_real_distribution<double> uniform(-1e9, 1e9);
+
+    if (name == "uniform" || name == "sorted" || name == "reverse" || name == "organ-pipe" || name == "nan")
+    {
+        for (double &value : data)
+            value = uniform(generator);
+        if (name == "sorted")
+            sort(data.begin(), data.end());
+        else if (name == "reverse")
+            sort(data.rbegin(), data.rend());
+        else if (name == "organ-pipe")
+        {
+            sort(data.begin(), data.end());
+            reverse(data.begin() + n / 2, data.end()); // goes up, then comes back down
+        }
+        else if (name == "nan")
+        {
+            for (size_t i = 0; i < n; i += 100) // 1% NaN
+                data[generator() % n] = numeric_limits<double>::quiet_NaN();
+        }
+    }
+    else if (name == "zipf")
+    {
+        // Rank r (1..K) is picked with probability proportional to 1 / r^1.1, so a few values repeat a lot
+        size_t distinct = max<size_t>(min<size_t>(n, 100000), 1);
+        vector<double> cumulative(distinct);
+        double total = 0;
+        for (size_t r = 0; r < distinct; r++)
+            cumulative[r] = total += 1.0 / pow((double)(r + 1), 1.1);
+        uniform_real_distribution<double> pick(0, total);
+        for (double &value : data)
+            value = (double)(lower_bound(cumulative.begin(), cumulative.end(), pick(generator)) - cumulative.begin());
+    }
+    else if (name == "few-unique")
+    {
+        for (double &value : data)
+            value = (double)(generator() % 16);
+    }
+    return data;
+}
+
+// True if the non-NaN values are in order (NaN has no place in an order, every engine may put it anywhere)
+bool isSortedIgnoringNaN(const vector<double> &data)
+{
+    double previous = -numeric_limits<double>::infinity();
+    for (double value : data)
+    {
+        if (value != value)
+            continue;
+        if (value < previous)
+            return false;
+        previous = value;
+    }
+    return true;
+}
+
+// Prints the CSV table for sizes 1K, 10K, ... up to maxN
+void runBenchmarkSuite(size_t maxN, int threadCount)
+{
+    // std::sort needs a strict weak order, which NaN breaks, so the reference sorts put NaN at the end
+    auto lessWithNaNLast = [](double a, double b) { return a < b || (a == a && b != b); };
+
+    vector<pair<string, function<void(vector<double> &)>>> engines = {
+        {"recursive", [](vector<double> &data) { mergeSort(data, 0, (int)data.size() - 1); }},
+        {"bottomup", [](vector<double> &data) { bottomUpMergeSort(data); }},
+        {"simd", [](vector<double> &data) { simdMergeSort(data); }},
+        {"adaptive", [](vector<double> &data) { adaptiveMergeSort(data); }},
+        {"radix", [](vector<double> &data) { radixSort(data); }},
+        {"auto", [](vector<double> &data) { autoSort(data, 1); }},
+        {"parallel", [threadCount](vector<double> &data) { parallelMergeSort(data, threadCount); }},
+        {"std::sort", [&](vector<double> &data) { sort(data.begin(), data.end(), lessWithNaNLast); }},
+        {"std::stable_sort", [&](vector<double> &data) { stable_sort(data.begin(), data.end(), lessWithNaNLast); }},
+    };
+    vector<string> distributions = {"uniform", "zipf", "sorted", "reverse", "organ-pipe", "few-unique", "nan"};
+
+    cout << "engine,distribution,n,ns_per_element,allocations,peak_heap_bytes,max_rss_kb,sorted" << endl;
+    for (size_t n = 1000; n <= maxN; n *= 10)
+    {
+        for (const string &distribution : distributions)
+        {
+            mt19937_64 generator(n * 31 + distribution.size());
+            vector<double> input = generateDistribution(distribution, n, generator);
+
+            for (auto &engine : engines)
+            {
+                // Repeat small sizes so every measurement covers at least ~2 million elements
+                int repetitions = (int)max<size_t>(1, 2000000 / n);
+                double seconds = 0;
+                long long allocations = 0, peakBytes = 0;
+                bool sorted = true;
+                for (int r = 0; r < repetitions; r++)
+                {
+                    vector<double> data = input;
+
+                    long long allocationsBefore = allocationCount.load();
+                    long long liveBefore = liveHeapBytes.load();
+                    peakHeapBytes.store(liveBefore);
+
+                    auto start = chrono::steady_clock::now();
+                    engine.second(data);
+                    seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+                    allocations = allocationCount.load() - allocationsBefore;
+                    peakBytes = peakHeapBytes.load() - liveBefore;
+                    sorted = sorted && isSortedIgnoringNaN(data);
+                }
+
+                cout << engine.first << "," << distribution << "," << n << "," << seconds / repetitions / n * 1e9 << ",";
+                if (countingAllocations)
+                    cout << allocations << "," << peakBytes << ",";
+                else
+                    cout << "n/a,n/a,";
+                cout << maxResidentKilobytes() << "," << (sorted ? "yes" : "no") << endl;
+            }
+        }
+    }
+}
+
+// The main function is where everything starts.
+// It reads in the number of elements and then the elements themselves.
+// After that, it calls `mergeSort` to sort them in descending order and prints them out.
+int main(int argc, char *argv[])
+{
+    string engine = "recursive";
+    int threadCount = -1; // not given
+    int scalingSize = 0;
+    long long benchmarkSize = 0;
+    bool compare = false;
+    bool printOrder = false;
+    bool binary = false;
+    bool timing = false;
+    string inputPath, outputPath;
+    ExternalSortOptions externalOptions;
+
+    for (int i = 1; i < argc; i++)
+    {
+        string flag = argv[i];
+        if (flag == "--parallel" && i + 1 < argc)
+        {
+            engine = "parallel";
+            threadCount = atoi(argv[++i]);
+        }
+        else if (flag == "--bottomup")
+        {
+            engine = "bottomup";
+        }
+        else if (flag == "--simd")
+        {
+            engine = "simd";
+        }
+        else if (flag == "--adaptive")
+        {
+            engine = "adaptive";
+        }
+        else if (flag == "--radix")
+        {
+            engine = "radix";
+        }
+        else if (flag == "--auto")
+        {
+            engine = "auto";
+        }
+        else if (flag == "--threads" && i + 1 < argc)
+        {
+            threadCount = atoi(argv[++i]);
+        }
+        else if (flag == "--argsort")
+        {
+            printOrder = true;
+        }
+        else if (flag == "--input" && i + 1 < argc)
+        {
+            inputPath = argv[++i];
+        }
+        else if (flag == "--output" && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (flag == "--binary")
+        {
+            binary = true;
+        }
+        else if (flag == "--timing")
+        {
+            timing = true;
+        }
+        else if (flag == "--compare")
+        {
+            compare = true;
+        }
+        else if (flag == "--external")
+        {
+            engine = "external";
+        }
+        else if (flag == "--memory" && i + 1 < argc)
+        {
+            externalOptions.memoryBudgetBytes = (size_t)atoll(argv[++i]) * 1024 * 1024;
+        }
+        else if (flag == "--tmpdir" && i + 1 < argc)
+        {
+            externalOptions.temporaryDirectory = argv[++i];
+        }
+        else if (flag == "--bench" && i + 1 < argc)
+        {
+            benchmarkSize = atoll(argv[++i]);
+        }
+        else if (flag == "--scaling" && i + 1 < argc)
+        {
+            scalingSize = atoi(argv[++i]);
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--parallel <threads> | --bottomup | --simd | --adaptive | --radix | --auto | --external [--memory <MB>] [--tmpdir <dir>]] [--threads <threads>] [--argsort] [--input <file>] [--output <file>] [--binary] [--timing] [--compare] [--bench <maxN>] [--scaling <N>] < in.txt" << endl;
+            return 1;
+        }
+    }
+
+    if (benchmarkSize > 0)
+    {
+        runBenchmarkSuite((size_t)benchmarkSize, max(threadCount, 0));
+        return 0;
+    }
+
+    // Benchmark mode: --parallel (if given) sets the biggest thread count of the table
+    if (scalingSize > 0)
+    {
+        printScalingTable(scalingSize, max(threadCount, 0));
+        return 0;
+    }
+
+    // Radix sort runs on one thread unless --threads says otherwise
+    int radixThreads = threadCount < 0 ? 1 : threadCount;
+
+    FILE *outputFile = outputPath.empty() ? stdout : fopen(outputPath.c_str(), binary ? "wb" : "w");
+    if (!outputFile)
+    {
+        cerr << "Error: could not create " << outputPath << endl;
+        return 1;
+    }
+
+    // The external engine streams the input itself, so it must not read everything into `arr` first.
+    // It reads with a stream (text) or fread (binary) instead of MappedInput, which would copy a pipe into RAM.
+    if (engine == "external")
+    {
+        BufferedWriter writer(outputFile);
+        if (binary)
+        {
+            FILE *inputFile = inputPath.empty() ? stdin : fopen(inputPath.c_str(), "rb");
+            if (!inputFile)
+            {
+                cerr << "Error: could not open " << inputPath << endl;
+                return 1;
+            }
+            vector<double> chunk(1 << 16);
+            size_t position = 0, filled = 0;
+            externalMergeSort([&](double &value)
+                              {
+                                  if (position == filled)
+                                  {
+                                      filled = fread(chunk.data(), sizeof(double), chunk.size(), inputFile);
+                                      position = 0;
+                                      if (filled == 0)
+                                          return false;
+                                  }
+                                  value = hostIsLittleEndian() ? chunk[position++] : swapBytes(chunk[position++]);
+                                  return true;
+                              },
+                              writer, true, externalOptions);
+            if (inputFile != stdin)
+                fclose(inputFile);
+        }
+        else
+        {
+            ifstream inputFile;
+            if (!inputPath.empty())
+            {
+                inputFile.open(inputPath);
+                if (!inputFile.is_open())
+                {
+                    cerr << "Error: could not open " << inputPath << endl;
+                    return 1;
+                }
+            }
+            istream &in = inputPath.empty() ? cin : inputFile;
+            long long count = 0;
+            in >> count;
+            long long remaining = count;
+            externalMergeSort([&](double &value)
+                              {
+                                  if (remaining == 0 || !(in >> value))
+                                      return false;
+                                  remaining--;
+                                  return true;
+                              },
+                              writer, false, externalOptions, count);
+        }
+        writer.flush();
+        if (outputFile != stdout)
+            fclose(outputFile);
+        return 0;
+    }
+
+    // Reading the input values (N and then the N values, or the raw doubles in binary mode)
+    auto parseStart = chrono::steady_clock::now();
+    vector<double> arr;
+    {
+        MappedInput input(inputPath);
+        arr = binary ? readBinaryInput(input) : readTextInput(input);
+    }
+    int N = (int)arr.size();
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - parseStart).count();
+
+    if (compare)
+        compareEngines(arr, max(threadCount, 0));
+
+    // argsort: print where every value was in the input instead of the values themselves
+    if (printOrder)
+    {
+        BufferedWriter writer(outputFile);
+        for (int index : argsort(arr, radixThreads))
+            writer.writeLine(index);
+        return 0;
+    }
+
+    // Sort the array using MergeSort (or one of the other engines when it was requested)
+    auto sortStart = chrono::steady_clock::now();
+    if (engine == "parallel")
+        parallelMergeSort(arr, threadCount);
+    else if (engine == "bottomup")
+        bottomUpMergeSort(arr);
+    else if (engine == "simd")
+        simdMergeSort(arr);
+    else if (engine == "adaptive")
+        adaptiveMergeSort(arr);
+    else if (engine == "radix")
+        radixSort(arr, radixThreads);
+    else if (engine == "auto")
+        autoSort(arr, radixThreads);
+    else
+        mergeSort(arr, 0, N - 1);
+
+    double sortSeconds = chrono::duration<double>(chrono::steady_clock::now() - sortStart).count();
+
+    // Print the sorted array from smallest to largest
+    auto writeStart = chrono::steady_clock::now();
+    {
+        BufferedWriter writer(outputFile);
+        for (const double &value : arr)
+        {
+            if (binary)
+                writer.writeBinary(value);
+            else
+                writer.writeLine(value);
+        }
+    }
+    if (outputFile != stdout)
+        fclose(outputFile);
+    double writeSeconds = chrono::duration<double>(chrono::steady_clock::now() - writeStart).count();
+
+    if (timing)
+        cerr << "parse: " << parseSeconds << " s, sort: " << sortSeconds << " s, write: " << writeSeconds << " s" << endl;
+
+    return 0;
+}
+
+/*
+ * Time Complexity Explanation:
+ *
+ * - The MergeSort algorithm works by dividing the array into two halves,
+ *   sorting each half recursively, and then merging the sorted halves.
+ *
+ * - The "divide" step splits the array in half, which takes constant time O(1).
+ * - The "conquer" step involves recursively sorting two halves, which takes O(log n) levels of recursion.
+ * - The "merge" step, where we combine the two halves, takes linear time O(n) for each level of recursion.
+ *
+ * - Overall, the time complexity of MergeSort is O(n log n).
+ *   This is because we have O(log n) levels of recursion, and at each level, we spend O(n) time to merge.
+ *
+ * - MergeSort is more efficient than simpler algorithms like Bubble Sort (O(n^2)),
+ *   especially for large datasets, because of its logarithmic splitting.
+ *
+ * - The parallel engine does the same O(n log n) work split over P threads. Because the merges are also
+ *   split with co-ranking (O(log n) binary search per slice), the critical path is about O(n / P * log n + log^3 n)
+ *   instead of the O(n) serial merge at the top of the recursion.
+ *
+ * - The bottom-up engine is still O(n log n) (insertion sort only runs on blocks of 32), but it needs one
+ *   O(n) scratch allocation in total instead of a new pair of vectors for every merge.
+ *
+ * - The SIMD engine has the same O(n log n) bound; it just does 4 comparisons per instruction without
+ *   branches, so the constant factor is smaller (about 2x faster than bottom-up on 400K random doubles).
+ *
+ * - The adaptive engine is O(n + n log r) for an input made of r natural runs: O(n) when the input is
+ *   already sorted (or reverse sorted), and still O(n log n) in the worst case thanks to the run-stack rules.
+ *
+ * - Radix sort is O(8 n): 8 counting-sort passes of one byte each (fewer when a byte is the same in every
+ *   key), plus O(n) extra memory for the second buffer. It wins over O(n log n) once log2(n) is bigger than
+ *   the cost of those passes, which is why --auto only uses it for inputs of a few thousand values or more.
+ *
+ * - The external engine does O(n log n) comparisons too (sorting runs of size M plus a log2(k) loser tree
+ *   merge of k = n / M runs), but the important cost is I/O: every value is read and written about twice
+ *   (once to create the runs, once in the final merge) when k fits in one merge pass.
  */
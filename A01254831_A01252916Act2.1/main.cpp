@@ -2,7 +2,21 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <unordered_set> // Using unordered_set to store hashed values
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -22,104 +36,1729 @@ using namespace std;
  *      ./main in3.txt
  *      ./main in4.txt
  *
+ * For very big files (several GB) there is a multi-threaded mode that maps the file in memory and splits the
+ * work between T threads (compile with -O2 -pthread):
+ *
+ *      g++ -std=c++17 -O2 -pthread -o main main.cpp
+ *      ./main big.txt --threads 8
+ *
+ * It prints exactly the same messages (same duplicate line and first occurrence) as the normal mode.
+ * The hash function can be chosen with --hash poly|fnv|wymix|crc32c (default wymix), and
+ *
+ *      ./main --hashbench
+ *
+ * measures the speed of each of them on short and long lines.
+ *
+ * For streams too big for the exact table, --approximate reads the lines once (a file, or stdin with "-")
+ * and keeps the memory under a fixed budget (default 64 MB) with a Bloom filter for the target false positive
+ * rate (default 0.01). It answers "all distinct" (certain) or "probably a duplicate at line N", and prints an
+ * estimate of the number of distinct lines:
+ *
+ *      ./main big.txt --approximate --memory 256 --fp 0.001
+ *      zcat big.txt.gz | ./main - --approximate
+ *
+ * --verify K makes the answer exact by re-reading the file to check the Bloom filter hits, at most K times:
+ *
+ *      ./main big.txt --approximate --verify 3
+ *
+ * --report lists every group of equal lines (sorted by the first line of the group) instead of stopping at
+ * the first duplicate. It also works within --memory, using temporary files in --tmpdir (default .):
+ *
+ *      ./main big.txt --report --memory 512 --tmpdir /scratch
+ *
+ * --longest-repeat finds the longest substring (of the whole file, not only whole lines) that appears twice:
+ *
+ *      ./main in3.txt --longest-repeat
+ *
  * Each of these test cases contains unique challenges to test the robustness of the "Hash String" algorithm.
  */
 
 // Hashing Strategy Explanation:
-// We're using a basic polynomial rolling hash function to convert each string into a unique numeric value.
-// This strategy is efficient for strings of varying lengths, and it avoids many common hashing issues,
-// such as collisions. Each character in the string is treated as a base-256 number (since there are 256
-// possible ASCII characters), and the hash is computed by accumulating powers of a small prime number (31).
-// Using a large prime modulus (1e9 + 7) ensures that we avoid overflow and minimize the chances of collisions,
-// even when dealing with long strings.
+// The hash function is a template parameter (the "Hasher") of the scans below, so it can be swapped from the
+// command line with --hash. Every hasher is a struct with a name and a static hash(data, length) function
+// that returns 64 bits:
+//  - PolynomialHasher ("poly"): the original polynomial rolling hash. Each byte is mapped to byte + 1 (so
+//    every one of the 256 values counts, not only lowercase letters like the old currentChar - 'a' + 1) and
+//    it is evaluated with Horner's rule modulo the Mersenne prime 2^61 - 1, where the modulo is a shift and
+//    an add instead of a division.
+//  - Fnv1aHasher ("fnv"): 64-bit FNV-1a, one xor and one multiply per byte.
+//  - MultiplyMixHasher ("wymix", the default): wyhash-style, reads 8 bytes at a time and mixes them with a
+//    64x64->128 bit multiply, so long lines cost about one multiply per 16 bytes.
+//  - Crc32cHasher ("crc32c"): two interleaved CRC32C streams over 8-byte words, with the SSE4.2 crc32
+//    instruction when the CPU has it and a lookup table otherwise.
+// ./main --hashbench compares their speed on short and long lines.
 
 // Time and Space Complexity:
 // The time complexity of this solution is O(N * L), where N is the number of strings in the input file,
 // and L is the average length of each string. This is because we compute the hash of each string by iterating
 // through its characters, and we perform a constant-time operation to check for duplicates using the hash set.
 //
-// The space complexity is O(N) since we store the hash of each string in an unordered_set. This ensures that
-// we only keep track of the unique hash values as we process the strings. The space needed for the hash set
-// grows proportionally to the number of distinct strings.
+// The space complexity is O(N * L): every distinct string is stored once in the arena of DistinctLineTable
+// (so we can compare the bytes when two hashes match), plus one 32-byte slot per string in the table.
+// Comparing the bytes makes the answer exact: a hash collision can no longer be reported as a duplicate.
 
-// Large prime number to avoid collisions due to overflow
-const int primeModulus = 1e9 + 7;
+// ---------------------------------------------------------------------------
+// Hashers
+// ---------------------------------------------------------------------------
 
-// Base for the polynomial hash function
-const int polynomialBase = 31;
+// Unaligned little-endian loads (memcpy compiles to a single mov)
+static inline unsigned long long read64(const char *data)
+{
+    unsigned long long value;
+    memcpy(&value, data, 8);
+    return value;
+}
 
-// This function computes a hash value for a given string
-unsigned long long computeStringHash(const string &inputString)
+static inline unsigned long long read32(const char *data)
+{
+    unsigned int value;
+    memcpy(&value, data, 4);
+    return value;
+}
+
+struct PolynomialHasher
+{
+    static constexpr const char *name = "poly";
+
+    // Mersenne prime modulus: x mod (2^61 - 1) = (x & (2^61 - 1)) + (x >> 61), no division needed
+    static constexpr unsigned long long modulus = (1ull << 61) - 1;
+
+    // Base for the polynomial hash function (bigger than the 256 byte values + 1)
+    static constexpr unsigned long long base = 257;
+
+    // x mod (2^61 - 1) for any x < 2^122 (a product of two reduced values plus a small term)
+    static inline unsigned long long reduce(unsigned __int128 value)
+    {
+        unsigned long long folded = (unsigned long long)(value & modulus) + (unsigned long long)(value >> 61);
+        return folded >= modulus ? folded - modulus : folded;
+    }
+
+    static unsigned long long hash(const char *data, size_t length)
+    {
+        unsigned long long hashValue = 0;
+        for (size_t i = 0; i < length; i++)
+            // hashValue = hashValue * base + (byte + 1), all modulo 2^61 - 1
+            hashValue = reduce((unsigned __int128)hashValue * base + ((unsigned char)data[i] + 1));
+        return hashValue;
+    }
+};
+
+struct Fnv1aHasher
+{
+    static constexpr const char *name = "fnv";
+
+    static unsigned long long hash(const char *data, size_t length)
+    {
+        unsigned long long hashValue = 14695981039346656037ull;
+        for (size_t i = 0; i < length; i++)
+        {
+            hashValue ^= (unsigned char)data[i];
+            hashValue *= 1099511628211ull;
+        }
+        return hashValue;
+    }
+};
+
+struct MultiplyMixHasher
 {
-    // Initialize the hash value and the multiplier for powers of the base
-    unsigned long long hashValue = 0;
-    unsigned long long basePower = 1; // Represents polynomialBase^i
+    static constexpr const char *name = "wymix";
 
-    // Calculate hash by iterating over each character of the string
-    for (char currentChar : inputString)
+    // Odd constants with about half of the bits set (the ones wyhash uses)
+    static constexpr unsigned long long secret0 = 0xa0761d6478bd642full;
+    static constexpr unsigned long long secret1 = 0xe7037ed1a0b428dbull;
+    static constexpr unsigned long long secret2 = 0x8ebc6af09c88c6e3ull;
+    static constexpr unsigned long long secret3 = 0x589965cc75374cc3ull;
+
+    // 64x64 -> 128 bit multiply, folded back to 64 bits: every input bit affects the middle output bits
+    static inline unsigned long long mix(unsigned long long a, unsigned long long b)
     {
-        // Accumulate hash value by adding the character's contribution
-        hashValue = (hashValue + (currentChar - 'a' + 1) * basePower) % primeModulus;
-        // Update the base power (polynomialBase^i) for the next character
-        basePower = (basePower * polynomialBase) % primeModulus;
+        unsigned __int128 product = (unsigned __int128)a * b;
+        return (unsigned long long)product ^ (unsigned long long)(product >> 64);
     }
 
-    return hashValue; // Return the computed hash value
+    static unsigned long long hash(const char *data, size_t length)
+    {
+        unsigned long long seed = secret0 ^ length;
+        unsigned long long a, b;
+        if (length <= 16)
+        {
+            // Short lines: two (possibly overlapping) loads cover every byte without a loop
+            if (length >= 8)
+            {
+                a = read64(data);
+                b = read64(data + length - 8);
+            }
+            else if (length >= 4)
+            {
+                a = read32(data);
+                b = read32(data + length - 4);
+            }
+            else if (length > 0)
+            {
+                a = ((unsigned long long)(unsigned char)data[0] << 16) | ((unsigned long long)(unsigned char)data[length / 2] << 8) |
+                    (unsigned char)data[length - 1];
+                b = 0;
+            }
+            else
+                a = b = 0;
+        }
+        else
+        {
+            // Long lines: three independent lanes of 16 bytes so the multiplies can overlap
+            const char *position = data;
+            size_t remaining = length;
+            if (remaining > 48)
+            {
+                unsigned long long lane1 = seed, lane2 = seed;
+                do
+                {
+                    seed = mix(read64(position) ^ secret1, read64(position + 8) ^ seed);
+                    lane1 = mix(read64(position + 16) ^ secret2, read64(position + 24) ^ lane1);
+                    lane2 = mix(read64(position + 32) ^ secret3, read64(position + 40) ^ lane2);
+                    position += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                seed ^= lane1 ^ lane2;
+            }
+            while (remaining > 16)
+            {
+                seed = mix(read64(position) ^ secret1, read64(position + 8) ^ seed);
+                position += 16;
+                remaining -= 16;
+            }
+            // The last 16 bytes of the line (they may overlap what was already hashed)
+            a = read64(data + length - 16);
+            b = read64(data + length - 8);
+        }
+        return mix(secret1 ^ length, mix(a ^ secret1, b ^ seed));
+    }
+};
+
+// CRC32C (Castagnoli polynomial, reflected), byte at a time with a 256-entry table, for CPUs without SSE4.2
+struct Crc32cTable
+{
+    unsigned int entries[256];
+
+    Crc32cTable()
+    {
+        for (unsigned int i = 0; i < 256; i++)
+        {
+            unsigned int crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+            entries[i] = crc;
+        }
+    }
+};
+
+static const Crc32cTable crc32cTable;
+
+static inline unsigned int crc32cByteSoftware(unsigned int crc, unsigned char byte)
+{
+    return crc32cTable.entries[(crc ^ byte) & 0xff] ^ (crc >> 8);
 }
 
-int main(int argumentCount, char *argumentValues[])
+// Same as the crc32 instruction on a 64-bit word: its 8 bytes in little-endian order
+static inline unsigned int crc32cWordSoftware(unsigned int crc, unsigned long long word)
 {
-    // Check if file name is provided
-    if (argumentCount != 2)
+    for (int i = 0; i < 8; i++)
+        crc = crc32cByteSoftware(crc, (unsigned char)(word >> (8 * i)));
+    return crc;
+}
+
+// Both streams and the tail, for either word/byte step (so the SSE4.2 and table versions give the same hash)
+template <class WordStep, class ByteStep>
+__attribute__((always_inline)) static inline unsigned long long crc32cPair(const char *data, size_t length, WordStep wordStep, ByteStep byteStep)
+{
+    unsigned int crcA = 0xffffffffu, crcB = 0x5bd1e995u;
+    size_t position = 0;
+    for (; position + 16 <= length; position += 16)
     {
-        cerr << "Usage: " << argumentValues[0] << " <input_file>\n";
-        return 1;
+        crcA = wordStep(crcA, read64(data + position));
+        crcB = wordStep(crcB, read64(data + position + 8));
+    }
+    if (position + 8 <= length)
+    {
+        crcA = wordStep(crcA, read64(data + position));
+        position += 8;
     }
+    for (; position < length; position++)
+        crcB = byteStep(crcB, (unsigned char)data[position]);
 
-    // Indicate which file is being processed
-    cout << "Processing file: " << argumentValues[1] << endl;
+    // Short lines only reach one of the streams, so finish with a multiply-xorshift to spread the 64 bits
+    unsigned long long hashValue = (((unsigned long long)crcA << 32) | crcB) ^ length;
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xff51afd7ed558ccdull;
+    hashValue ^= hashValue >> 33;
+    return hashValue;
+}
 
-    // Open the file
-    ifstream inputFile(argumentValues[1]);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
 
-    // Check if file is open
-    if (!inputFile.is_open())
+__attribute__((target("sse4.2"))) static inline unsigned int crc32cWordSse42(unsigned int crc, unsigned long long word)
+{
+#if defined(__x86_64__)
+    return (unsigned int)_mm_crc32_u64(crc, word);
+#else
+    return _mm_crc32_u32(_mm_crc32_u32(crc, (unsigned int)word), (unsigned int)(word >> 32));
+#endif
+}
+
+__attribute__((target("sse4.2"))) static inline unsigned int crc32cByteSse42(unsigned int crc, unsigned char byte)
+{
+    return _mm_crc32_u8(crc, byte);
+}
+
+__attribute__((target("sse4.2"))) static unsigned long long crc32cHashSse42(const char *data, size_t length)
+{
+    return crc32cPair(data, length, crc32cWordSse42, crc32cByteSse42);
+}
+
+static const bool cpuHasSse42 = __builtin_cpu_supports("sse4.2");
+#else
+static const bool cpuHasSse42 = false;
+#endif
+
+struct Crc32cHasher
+{
+    static constexpr const char *name = "crc32c";
+
+    static unsigned long long hash(const char *data, size_t length)
     {
-        cerr << "Error: Could not open file " << argumentValues[1] << "\n";
-        return 1;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        if (cpuHasSse42)
+            return crc32cHashSse42(data, length);
+#endif
+        return crc32cPair(data, length, crc32cWordSoftware, crc32cByteSoftware);
+    }
+};
+
+// This function computes a hash value for a given string (the polynomial one, kept for compatibility)
+unsigned long long computeStringHash(const string &inputString)
+{
+    return PolynomialHasher::hash(inputString.data(), inputString.size());
+}
+
+// Exact duplicate detector.
+// Two different strings can have the same hash, so a hash match alone is not a proof of a duplicate (with the
+// old 1e9+7 modulus, false positives start to appear after some tens of thousands of lines). This table
+// keeps the bytes of every distinct line once, one after the other in a big "arena" buffer, and only reports
+// a duplicate after comparing the actual bytes.
+// It is an open-addressing table (linear probing over one flat array of slots), so there is no node
+// allocation per line like in unordered_map: just the arena and the slot array, both growing by doubling.
+// When the whole file is mapped in memory (see parallelDuplicateScan) the lines are already stored somewhere,
+// so the table can be given the start of the mapping and then it just remembers offsets into it instead of
+// copying the bytes into the arena.
+class DistinctLineTable
+{
+public:
+    explicit DistinctLineTable(const char *mappedFile = nullptr) : slots(1024), mappedFile(mappedFile) {}
+
+    // Adds a line. Returns the line number of its first occurrence if it was already there, otherwise 0.
+    // With a mapped file, data must point inside it.
+    long long insert(const char *data, size_t length, unsigned long long hashValue, long long lineNumber)
+    {
+        if ((used + 1) * 10 > slots.size() * 7) // keep the load factor under 70%
+            grow();
+
+        size_t mask = slots.size() - 1;
+        for (size_t position = hashValue & mask;; position = (position + 1) & mask)
+        {
+            Slot &slot = slots[position];
+            if (slot.lineNumber == 0)
+            {
+                slot.hashValue = hashValue;
+                slot.length = length;
+                slot.lineNumber = lineNumber;
+                if (mappedFile != nullptr)
+                    slot.offset = data - mappedFile;
+                else
+                {
+                    slot.offset = arena.size();
+                    arena.insert(arena.end(), data, data + length);
+                }
+                used++;
+                return 0;
+            }
+            // Same hash: confirm with the bytes before calling it a duplicate
+            if (slot.hashValue == hashValue && slot.length == length && memcmp(bytesOf(slot), data, length) == 0)
+                return slot.lineNumber;
+        }
+    }
+
+    size_t size() const { return used; }
+
+private:
+    struct Slot
+    {
+        unsigned long long hashValue = 0;
+        unsigned long long offset = 0; // where the line's bytes start in the arena (or in the mapped file)
+        unsigned long long length = 0;
+        long long lineNumber = 0; // 0 = empty slot (line numbers start at 1)
+    };
+
+    const char *bytesOf(const Slot &slot) const
+    {
+        return mappedFile != nullptr ? mappedFile + slot.offset : arena.data() + slot.offset;
+    }
+
+    void grow()
+    {
+        vector<Slot> bigger(slots.size() * 2);
+        size_t mask = bigger.size() - 1;
+        for (const Slot &slot : slots)
+        {
+            if (slot.lineNumber == 0)
+                continue;
+            size_t position = slot.hashValue & mask;
+            while (bigger[position].lineNumber != 0)
+                position = (position + 1) & mask;
+            bigger[position] = slot;
+        }
+        slots.swap(bigger);
+    }
+
+    vector<Slot> slots;
+    vector<char> arena;
+    const char *mappedFile;
+    size_t used = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Multi-threaded scan of a memory-mapped file
+// ---------------------------------------------------------------------------
+
+// Read-only mapping of a whole file. The pages are loaded by the OS on demand, so a 40 GB file does not need
+// 40 GB of RAM, and there is no getline copy per line.
+class MappedFile
+{
+public:
+    explicit MappedFile(const char *path)
+    {
+        descriptor = open(path, O_RDONLY);
+        if (descriptor < 0)
+            return;
+        struct stat information;
+        if (fstat(descriptor, &information) != 0)
+            return;
+        length = information.st_size;
+        if (length == 0)
+        {
+            opened = true; // empty file: nothing to map
+            return;
+        }
+        void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED)
+            return;
+        madvise(address, length, MADV_SEQUENTIAL);
+        bytes = (const char *)address;
+        opened = true;
     }
 
-    // Declare a map to store hashes and their respective line number
-    unordered_map<unsigned long long, int> hashMap;
+    ~MappedFile()
+    {
+        if (bytes != nullptr)
+            munmap((void *)bytes, length);
+        if (descriptor >= 0)
+            close(descriptor);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return opened; }
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    int descriptor = -1;
+    const char *bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+};
+
+// A duplicated line and the line where it appeared first (line = 0 means no duplicate).
+struct DuplicatePair
+{
+    long long line = 0;
+    long long firstOccurrence = 0;
+};
+
+// Returns the position right after the next '\n' at or after position (or the end of the data).
+size_t nextLineStart(const char *data, size_t size, size_t position)
+{
+    if (position >= size)
+        return size;
+    const char *newline = (const char *)memchr(data + position, '\n', size - position);
+    return newline == nullptr ? size : newline - data + 1;
+}
+
+// Finds the same duplicate as the getline loop in main, using threadCount threads.
+//
+// The file is processed in batches of a few MB per thread, and every batch in two phases:
+//  1. The batch is cut into one chunk per thread, always right after a '\n'. Each thread splits its chunk
+//     into lines, hashes them, and appends (hash, position, length, local line number) to one list per shard.
+//     The shard is picked with the top bits of the (spread) hash; the tables use the low bits for the slot.
+//     Each thread counts its lines, so once all of them finish the global number of the first line of each
+//     chunk is just a prefix sum.
+//  2. Each shard has its own DistinctLineTable, and every shard is handled by exactly one thread, which
+//     inserts the lines of the shard from chunk 0, chunk 1, ... in order, so inside a shard the lines go
+//     in file order. Two equal lines always have the same hash, so they always land in the same shard; the
+//     first line that hits an existing entry is the earliest duplicate of that shard, and the earliest one
+//     of the file is the smallest one over all the shards.
+// The first batch with a duplicate stops the scan, like the return in the sequential loop.
+template <class Hasher>
+DuplicatePair parallelDuplicateScan(const char *data, size_t size, int threadCount)
+{
+    struct LineReference
+    {
+        unsigned long long hashValue;
+        unsigned long long offset;
+        unsigned long long length;
+        long long localLine; // 1-based line number inside the chunk
+    };
+
+    const size_t batchBytesPerThread = 16u << 20;
+
+    int shardCount = 1;
+    while (shardCount < threadCount * 4)
+        shardCount *= 2;
+    int shardShift = 64;
+    for (int count = shardCount; count > 1; count /= 2)
+        shardShift--;
+
+    vector<DistinctLineTable> shards(shardCount, DistinctLineTable(data));
+    vector<vector<vector<LineReference>>> routed(threadCount, vector<vector<LineReference>>(shardCount));
+    vector<long long> linesInChunk(threadCount);
+    vector<long long> firstLineOfChunk(threadCount + 1);
+    vector<DuplicatePair> shardDuplicate(shardCount);
+
+    long long linesBefore = 0;
+    size_t batchStart = 0;
+    while (batchStart < size)
+    {
+        // Cut the batch and its chunks right after newlines so no line is split between two threads
+        vector<size_t> chunkStart(threadCount + 1);
+        chunkStart[0] = batchStart;
+        for (int t = 1; t <= threadCount; t++)
+            chunkStart[t] = nextLineStart(data, size, min(size, batchStart + batchBytesPerThread * t) - 1);
+
+        // Phase 1: split the chunks into lines and route them to the shards
+        vector<thread> workers;
+        for (int t = 0; t < threadCount; t++)
+        {
+            workers.emplace_back([&, t]()
+            {
+                for (vector<LineReference> &list : routed[t])
+                    list.clear();
+                long long localLine = 0;
+                size_t position = chunkStart[t];
+                size_t end = chunkStart[t + 1];
+                while (position < end)
+                {
+                    const char *newline = (const char *)memchr(data + position, '\n', end - position);
+                    size_t lineEnd = newline == nullptr ? end : newline - data;
+                    unsigned long long hashValue = Hasher::hash(data + position, lineEnd - position);
+                    // Spread the hash before taking the top bits (the polynomial hash only has 61 bits)
+                    routed[t][(hashValue * 0x9E3779B97F4A7C15ull) >> shardShift].push_back({hashValue, position, lineEnd - position, ++localLine});
+                    position = lineEnd + 1;
+                }
+                linesInChunk[t] = localLine;
+            });
+        }
+        for (thread &worker : workers)
+            worker.join();
+
+        firstLineOfChunk[0] = linesBefore;
+        for (int t = 0; t < threadCount; t++)
+            firstLineOfChunk[t + 1] = firstLineOfChunk[t] + linesInChunk[t];
+
+        // Phase 2: every shard inserts its lines in file order
+        atomic<int> nextShard(0);
+        workers.clear();
+        for (int t = 0; t < threadCount; t++)
+        {
+            workers.emplace_back([&]()
+            {
+                for (int shard = nextShard++; shard < shardCount; shard = nextShard++)
+                {
+                    DistinctLineTable &table = shards[shard];
+                    for (int chunk = 0; chunk < threadCount && shardDuplicate[shard].line == 0; chunk++)
+                    {
+                        for (const LineReference &line : routed[chunk][shard])
+                        {
+                            long long lineNumber = firstLineOfChunk[chunk] + line.localLine;
+                            long long firstOccurrence = table.insert(data + line.offset, line.length, line.hashValue, lineNumber);
+                            if (firstOccurrence != 0)
+                            {
+                                shardDuplicate[shard] = {lineNumber, firstOccurrence};
+                                break;
+                            }
+                        }
+                    }
+                }
+            });
+        }
+        for (thread &worker : workers)
+            worker.join();
+
+        DuplicatePair earliest;
+        for (const DuplicatePair &pair : shardDuplicate)
+            if (pair.line != 0 && (earliest.line == 0 || pair.line < earliest.line))
+                earliest = pair;
+        if (earliest.line != 0)
+            return earliest;
+
+        linesBefore = firstLineOfChunk[threadCount];
+        batchStart = chunkStart[threadCount];
+    }
+    return DuplicatePair();
+}
+
+// The original getline loop: returns the first line that is equal to an earlier one.
+template <class Hasher>
+DuplicatePair sequentialDuplicateScan(istream &inputFile)
+{
+    // Table with every distinct line seen so far and the line number where it first appeared
+    DistinctLineTable distinctLines;
 
     // Read each string from the file
     string currentString;
-    int lineNumber = 0; // Keeps track of line number
+    long long lineNumber = 0; // Keeps track of line number
 
     while (getline(inputFile, currentString)) // Use getline to read the whole line
     {
         lineNumber++; // Increment line number as we read each line
 
         // Compute the hash of the current string
-        unsigned long long hashValue = computeStringHash(currentString);
+        unsigned long long hashValue = Hasher::hash(currentString.data(), currentString.size());
+
+        // Insert it; if the same bytes were already in the table we found a duplicate
+        long long firstOccurrence = distinctLines.insert(currentString.data(), currentString.size(), hashValue, lineNumber);
+        if (firstOccurrence != 0)
+            return {lineNumber, firstOccurrence};
+    }
+    return DuplicatePair();
+}
+
+// Options of the modes that work within a memory budget
+struct ScanOptions
+{
+    bool approximate = false;            // --approximate
+    bool report = false;                 // --report
+    double memoryMegabytes = 64;         // --memory
+    double falsePositiveRate = 0.01;     // --fp
+    int verifyPasses = 0;                // --verify (0 = no exact verification)
+    string temporaryDirectory = ".";     // --tmpdir
+};
+
+// ---------------------------------------------------------------------------
+// Bounded-memory mode: blocked Bloom filter + HyperLogLog
+// ---------------------------------------------------------------------------
+
+// Murmur3 64-bit finalizer: a bijection that spreads every input bit over all the output bits, so the Bloom
+// filter and HyperLogLog can take bits from anywhere in the hash (the polynomial hash only has 61 bits).
+static inline unsigned long long spreadHash(unsigned long long hashValue)
+{
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xff51afd7ed558ccdull;
+    hashValue ^= hashValue >> 33;
+    hashValue *= 0xc4ceb9fe1a85ec53ull;
+    hashValue ^= hashValue >> 33;
+    return hashValue;
+}
 
-        // Check if the hash already exists in the map (duplicate string detected)
-        if (hashMap.find(hashValue) != hashMap.end())
+// Blocked Bloom filter: each line chooses one 64-byte block (one cache line) and sets its k bits inside it,
+// so a lookup costs one cache miss instead of k. The size comes from the memory budget and k from the
+// target false-positive rate p (k = log2(1/p)); with m bits the filter keeps a rate of about p up to
+// n = m ln(2)^2 / ln(1/p) lines (the blocked layout is slightly worse than a classic filter because the
+// blocks do not fill evenly).
+class BlockedBloomFilter
+{
+public:
+    BlockedBloomFilter(size_t bytes, double falsePositiveRate)
+    {
+        blocks.resize(max<size_t>(1, bytes / sizeof(Block)));
+        hashCount = max(1, (int)lround(-log2(falsePositiveRate)));
+        capacity = (double)blocks.size() * 512 * log(2) * log(2) / -log(falsePositiveRate);
+    }
+
+    // Sets the bits of the line. Returns true if all of them were already set (the line was possibly seen).
+    bool testAndAdd(unsigned long long hashValue)
+    {
+        unsigned long long blockHash = spreadHash(hashValue);
+        unsigned long long bitHash = spreadHash(hashValue ^ 0x9E3779B97F4A7C15ull);
+        Block &block = blocks[(size_t)(((unsigned __int128)blockHash * blocks.size()) >> 64)];
+
+        // Double hashing inside the block: bit i = top 9 bits of (first + i * step)
+        unsigned int first = (unsigned int)bitHash, step = (unsigned int)(bitHash >> 32) | 1;
+        bool allSet = true;
+        for (int i = 0; i < hashCount; i++)
         {
-            cout << "Strings are not distinct. Duplicate found at line " << lineNumber
-                 << ". First occurrence was at line " << hashMap[hashValue] << ".\n";
-            return 0;
+            unsigned int bit = (first + i * step) >> 23;
+            unsigned long long mask = 1ull << (bit & 63);
+            allSet &= (block.words[bit >> 6] & mask) != 0;
+            block.words[bit >> 6] |= mask;
         }
+        return allSet;
+    }
+
+    size_t bytes() const { return blocks.size() * sizeof(Block); }
+    int hashes() const { return hashCount; }
+    double linesForTargetRate() const { return capacity; }
+
+private:
+    struct alignas(64) Block
+    {
+        unsigned long long words[8] = {};
+    };
+
+    vector<Block> blocks;
+    int hashCount;
+    double capacity;
+};
+
+// HyperLogLog distinct-count estimate: the top precision bits of the hash choose a register, and the register
+// keeps the longest run of leading zeros seen in the remaining bits. 2^14 one-byte registers (16 KB) give
+// a standard error of 1.04 / sqrt(2^14), about 0.8%, for any number of lines.
+class HyperLogLog
+{
+public:
+    static const int precision = 14;
 
-        // Insert the hash and line number into the map
-        hashMap[hashValue] = lineNumber;
+    HyperLogLog() : registers(1u << precision) {}
+
+    void add(unsigned long long hashValue)
+    {
+        unsigned long long spread = spreadHash(hashValue);
+        size_t index = spread >> (64 - precision);
+        unsigned long long rest = spread << precision;
+        unsigned char rank = rest == 0 ? 64 - precision + 1 : __builtin_clzll(rest) + 1;
+        if (rank > registers[index])
+            registers[index] = rank;
+    }
+
+    double estimate() const
+    {
+        double registerCount = registers.size();
+        double sum = 0;
+        size_t zeroRegisters = 0;
+        for (unsigned char rank : registers)
+        {
+            sum += ldexp(1.0, -rank);
+            zeroRegisters += rank == 0;
+        }
+        double estimate = 0.7213 / (1 + 1.079 / registerCount) * registerCount * registerCount / sum;
+        // Small counts: linear counting on the empty registers is more precise
+        if (estimate <= 2.5 * registerCount && zeroRegisters > 0)
+            estimate = registerCount * log(registerCount / zeroRegisters);
+        return estimate;
     }
 
-    // If we reach here, all strings are distinct
-    cout << "All strings are distinct\n";
+private:
+    vector<unsigned char> registers;
+};
 
-    // Close the file
-    inputFile.close();
+// A Bloom filter hit waiting to be checked against the actual lines (only with --verify)
+struct BloomCandidate
+{
+    unsigned long long hashValue;
+    unsigned long long offset; // bytes in the candidate arena
+    unsigned long long length;
+    long long lineNumber;
+    long long firstSeen; // first line with the same bytes, filled by the verification pass
+};
+
+// Re-reads the file up to the last candidate and finds the first line equal to each candidate.
+// A candidate is a real duplicate if that first line is before it; returns the earliest real one.
+template <class Hasher>
+DuplicatePair verifyBloomCandidates(const char *fileName, vector<BloomCandidate> &candidates, const vector<char> &arena)
+{
+    sort(candidates.begin(), candidates.end(), [](const BloomCandidate &left, const BloomCandidate &right)
+         { return left.hashValue < right.hashValue; });
 
+    ifstream inputFile(fileName);
+    string currentString;
+    long long lastLine = 0;
+    for (const BloomCandidate &candidate : candidates)
+        lastLine = max(lastLine, candidate.lineNumber);
+
+    for (long long lineNumber = 1; lineNumber <= lastLine && getline(inputFile, currentString); lineNumber++)
+    {
+        unsigned long long hashValue = Hasher::hash(currentString.data(), currentString.size());
+        auto match = lower_bound(candidates.begin(), candidates.end(), hashValue, [](const BloomCandidate &candidate, unsigned long long value)
+                                 { return candidate.hashValue < value; });
+        for (; match != candidates.end() && match->hashValue == hashValue; ++match)
+            if (match->firstSeen == 0 && match->length == currentString.size() &&
+                memcmp(&arena[match->offset], currentString.data(), currentString.size()) == 0)
+                match->firstSeen = lineNumber;
+    }
+
+    DuplicatePair earliest;
+    for (const BloomCandidate &candidate : candidates)
+        if (candidate.firstSeen != 0 && candidate.firstSeen < candidate.lineNumber &&
+            (earliest.line == 0 || candidate.lineNumber < earliest.line))
+            earliest = {candidate.lineNumber, candidate.firstSeen};
+    return earliest;
+}
+
+// Reads the lines once, with memory bounded by options.memoryMegabytes no matter how many lines there are,
+// so it also works on stdin or a pipe:
+//  - The budget is a blocked Bloom filter. A line whose bits are not all set is certainly new, and the second
+//    copy of a line always finds its bits set (no false negatives), so if no line hits the filter all the
+//    lines are distinct for sure.
+//  - A hit is only a probable duplicate: it is a false positive with probability about
+//    options.falsePositiveRate while the filter holds fewer lines than its capacity (more after that). The
+//    verdict gives the first hit and how many there were.
+//  - A HyperLogLog sketch estimates the number of distinct lines on the way.
+// With --verify K (options.verifyPasses = K > 0) a quarter of the budget keeps the hits as candidates, in line
+// order. When that buffer is full (or at the end) the file is read again up to the last candidate to check
+// them against the real lines (verifyBloomCandidates). The earliest duplicate of the file always hits the
+// filter, so the first batch with a real duplicate gives the exact earliest one. The file is re-read at most
+// K times, so I/O stays at most (K + 1) times the file; if the K passes confirm nothing, the verdict stays
+// probabilistic from the first unchecked hit on. Verification needs a file that can be read again.
+// Returns the exit code of the program.
+template <class Hasher>
+int approximateDuplicateScan(const char *fileName, istream &inputFile, const ScanOptions &options)
+{
+    size_t budget = (size_t)(options.memoryMegabytes * (1 << 20));
+    bool verifying = options.verifyPasses > 0;
+    BlockedBloomFilter bloomFilter(verifying ? budget / 4 * 3 : budget, options.falsePositiveRate);
+    HyperLogLog distinctCounter;
+    size_t candidateBudget = budget / 4;
+
+    vector<BloomCandidate> candidates;
+    vector<char> arena;
+    long long verificationPasses = 0, bloomHits = 0;
+    long long firstHit = 0;       // first Bloom filter hit
+    long long firstUnchecked = 0; // first hit that no verification pass has checked
+    DuplicatePair duplicate;
+
+    string currentString;
+    long long lineNumber = 0;
+    while (true)
+    {
+        bool hasLine = (bool)getline(inputFile, currentString);
+        if (hasLine)
+        {
+            lineNumber++;
+            unsigned long long hashValue = Hasher::hash(currentString.data(), currentString.size());
+            distinctCounter.add(hashValue);
+            if (bloomFilter.testAndAdd(hashValue))
+            {
+                bloomHits++;
+                if (firstHit == 0)
+                    firstHit = lineNumber;
+                if (firstUnchecked == 0)
+                    firstUnchecked = lineNumber;
+                // Keep candidates only while there are verification passes left and nothing is confirmed yet
+                if (verifying && duplicate.line == 0 && verificationPasses < options.verifyPasses)
+                {
+                    candidates.push_back({hashValue, arena.size(), currentString.size(), lineNumber, 0});
+                    arena.insert(arena.end(), currentString.begin(), currentString.end());
+                }
+            }
+        }
+
+        bool bufferFull = arena.size() + candidates.size() * sizeof(BloomCandidate) >= candidateBudget;
+        if (!candidates.empty() && (bufferFull || !hasLine))
+        {
+            verificationPasses++;
+            duplicate = verifyBloomCandidates<Hasher>(fileName, candidates, arena);
+            // Every hit so far was in the buffer, so the next unchecked one is still to come
+            firstUnchecked = 0;
+            candidates.clear();
+            arena.clear();
+        }
+        if (!hasLine)
+            break;
+    }
+
+    cout << fixed << setprecision(1) << "Bloom filter: " << bloomFilter.bytes() / 1048576.0 << " MB, "
+         << bloomFilter.hashes() << " hashes, false positive rate " << defaultfloat << options.falsePositiveRate
+         << " up to " << fixed << setprecision(0) << bloomFilter.linesForTargetRate() << " lines\n";
+    cout << "Lines read: " << lineNumber << ", Bloom filter hits: " << bloomHits;
+    if (verifying)
+        cout << ", verification passes: " << verificationPasses << " (at most " << options.verifyPasses << ")";
+    cout << "\n";
+    cout << "Estimated distinct lines (HyperLogLog, ~0.8% error): " << distinctCounter.estimate() << "\n"
+         << defaultfloat;
+
+    if (duplicate.line != 0)
+        cout << "Strings are not distinct. Duplicate found at line " << duplicate.line
+             << ". First occurrence was at line " << duplicate.firstOccurrence << ".\n";
+    else if (bloomHits == 0 || (verifying && firstUnchecked == 0))
+        cout << "All strings are distinct\n";
+    else
+    {
+        long long possibleLine = verifying ? firstUnchecked : firstHit;
+        cout << "Strings are probably not distinct. Possible duplicate at line " << possibleLine
+             << (verifying ? " (first hit after the verification passes)" : " (first Bloom filter hit)")
+             << (possibleLine > bloomFilter.linesForTargetRate() ? ", the filter was over its capacity there so it may be a false positive\n"
+                                                                  : "\n");
+    }
     return 0;
-}
\ No newline at end of file
+}
+
+// ---------------------------------------------------------------------------
+// Full duplicate report with on-disk hash partitioning
+// ---------------------------------------------------------------------------
+
+// A file opened for sequential reading or writing with its own big stdio buffer. It is closed when the object
+// goes away, so an error path can't leak it.
+class BufferedFile
+{
+public:
+    BufferedFile() = default;
+    BufferedFile(const BufferedFile &) = delete;
+    BufferedFile &operator=(const BufferedFile &) = delete;
+    ~BufferedFile() { close(); }
+
+    bool open(const string &path, const char *mode, size_t bufferSize)
+    {
+        buffer.resize(bufferSize);
+        file = fopen(path.c_str(), mode);
+        if (file != nullptr)
+            setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+        return file != nullptr;
+    }
+
+    // Returns false if the buffered data could not be written. The buffer memory is given back too.
+    bool close()
+    {
+        bool closed = file == nullptr || fclose(file) == 0;
+        file = nullptr;
+        vector<char>().swap(buffer);
+        return closed;
+    }
+
+    bool write(const void *data, size_t bytes) { return fwrite(data, 1, bytes, file) == bytes; }
+    bool read(void *data, size_t bytes) { return fread(data, 1, bytes, file) == bytes; }
+
+    // Tells a read that stopped because of an error from one that reached the end of the file
+    bool failed() const { return file != nullptr && ferror(file) != 0; }
+
+private:
+    FILE *file = nullptr;
+    vector<char> buffer;
+};
+
+// Names the temporary files of one report and removes every one that is still there when the object goes away,
+// so they are cleaned up even when the report stops early because of an error.
+class TemporaryFiles
+{
+public:
+    explicit TemporaryFiles(const string &directory)
+        : directory(directory), prefix(directory + "/distinct_" + to_string(getpid()) + "_" +
+                 to_string((long long)chrono::steady_clock::now().time_since_epoch().count()) + "_")
+    {
+    }
+
+    TemporaryFiles(const TemporaryFiles &) = delete;
+    TemporaryFiles &operator=(const TemporaryFiles &) = delete;
+
+    ~TemporaryFiles()
+    {
+        for (const string &path : paths)
+            ::remove(path.c_str());
+    }
+
+    string create(const string &kind)
+    {
+        paths.push_back(prefix + kind + to_string(created++));
+        return paths.back();
+    }
+
+    // Removes a file as soon as it is not needed, to give the disk space back
+    void remove(const string &path)
+    {
+        ::remove(path.c_str());
+        paths.erase(find(paths.begin(), paths.end(), path));
+    }
+
+    const string directory;
+
+private:
+    string prefix;
+    vector<string> paths;
+    long long created = 0;
+};
+
+// A bucket holds records of (hash, line number, length) followed by the bytes of the line
+struct LineRecord
+{
+    unsigned long long header[3];
+    string bytes;
+
+    bool read(BufferedFile &file)
+    {
+        if (!file.read(header, sizeof(header)))
+            return false;
+        bytes.resize(header[2]);
+        return file.read(&bytes[0], header[2]);
+    }
+
+    bool write(BufferedFile &file) const
+    {
+        return file.write(header, sizeof(header)) && file.write(bytes.data(), bytes.size());
+    }
+
+    size_t size() const { return sizeof(header) + bytes.size(); }
+};
+
+// Deepest partition level: after 8 levels of up to 128 buckets any bucket is read into memory as it is
+const int maxPartitionLevels = 8;
+
+// Most temporary files open at the same time, as buckets of one partition step or as runs of one merge. It
+// stays far from the usual limit of 256 open files, with room for the input and the standard streams.
+const size_t maxOpenTemporaryFiles = 128;
+
+// Number of bucket bits for bytes of records: a bucket needs its bytes in the arena plus the slots, and with
+// short lines the slots (32 bytes per line, at most 70% full) take several times the size of the text, so
+// count 8 bytes of table per byte and make every bucket fit in half of the budget. At most
+// maxOpenTemporaryFiles buckets per level; bigger inputs go through more levels.
+int bucketBitsFor(unsigned long long bytes, size_t budget)
+{
+    int bucketBits = 0;
+    while ((1u << bucketBits) < maxOpenTemporaryFiles && (bytes * 8 >> bucketBits) > budget / 2)
+        bucketBits++;
+    return bucketBits;
+}
+
+// Bucket of a line at a partition level. Every level mixes another seed into the hash, so the lines that
+// shared a bucket at one level spread over the sub-buckets of the next one.
+static inline size_t bucketOf(unsigned long long hashValue, int level, int bucketBits)
+{
+    return bucketBits == 0 ? 0 : spreadHash(hashValue + level * 0x9E3779B97F4A7C15ull) >> (64 - bucketBits);
+}
+
+// The bucket files of one partition step, sharing a quarter of the budget as write buffers
+struct Partition
+{
+    Partition(int bucketBits, int level) : bucketBits(bucketBits), level(level), files(1 << bucketBits), sizes(1 << bucketBits, 0) {}
+
+    bool open(TemporaryFiles &temporaries, size_t budget)
+    {
+        for (BufferedFile &file : files)
+        {
+            paths.push_back(temporaries.create("bucket"));
+            if (!file.open(paths.back(), "wb", max<size_t>(4096, budget / 4 / files.size())))
+                return false;
+        }
+        return true;
+    }
+
+    bool add(const LineRecord &record)
+    {
+        size_t bucket = bucketOf(record.header[0], level, bucketBits);
+        sizes[bucket] += record.size();
+        return record.write(files[bucket]);
+    }
+
+    bool close()
+    {
+        bool closed = true;
+        for (BufferedFile &file : files)
+            closed &= file.close();
+        return closed;
+    }
+
+    int bucketBits, level;
+    vector<BufferedFile> files;
+    vector<string> paths;
+    vector<unsigned long long> sizes;
+};
+
+// What the steps of one report share: the budget, the temporary files, the buffered links and the first error
+struct ReportState
+{
+    size_t budget;
+    TemporaryFiles &temporaries;
+    vector<DuplicatePair> links;
+    size_t linkCapacity;
+    vector<string> runPaths;
+    string &error; // the reason of the first failure, for the caller
+
+    bool writeFailed()
+    {
+        error = "Could not write the temporary files in " + temporaries.directory;
+        return false;
+    }
+
+    bool readFailed(const string &path)
+    {
+        error = "Could not read the temporary file " + path;
+        return false;
+    }
+};
+
+// Sorts the collected (first occurrence, line) links and writes them as one sorted run file
+bool writeLinkRun(ReportState &state)
+{
+    vector<DuplicatePair> &links = state.links;
+    sort(links.begin(), links.end(), [](const DuplicatePair &left, const DuplicatePair &right)
+         { return left.firstOccurrence != right.firstOccurrence ? left.firstOccurrence < right.firstOccurrence : left.line < right.line; });
+    state.runPaths.push_back(state.temporaries.create("links"));
+    BufferedFile file;
+    bool written = file.open(state.runPaths.back(), "wb", 1 << 20) &&
+                   file.write(links.data(), links.size() * sizeof(DuplicatePair));
+    written &= file.close();
+    links.clear();
+    return written || state.writeFailed();
+}
+
+// Finds the duplicates of one bucket file (bytes long, made at partition level - 1) and removes it.
+// A bucket that is still too big for the budget is split again with the seed of this level and its
+// sub-buckets are handled one after the other, so the memory does not depend on the size of the file.
+// Returns false (with state.error) if a temporary file could not be read or written.
+bool findBucketDuplicates(ReportState &state, const string &path, unsigned long long bytes, int level)
+{
+    BufferedFile input;
+    if (!input.open(path, "rb", 1 << 20))
+        return state.readFailed(path);
+    LineRecord record;
+
+    int bucketBits = bucketBitsFor(bytes, state.budget);
+    if (bucketBits > 0 && level < maxPartitionLevels)
+    {
+        Partition partition(bucketBits, level);
+        if (!partition.open(state.temporaries, state.budget))
+            return state.writeFailed();
+        while (record.read(input))
+            if (!partition.add(record))
+                return state.writeFailed();
+        if (!partition.close())
+            return state.writeFailed();
+        if (input.failed())
+            return state.readFailed(path);
+        input.close();
+        state.temporaries.remove(path);
+
+        for (size_t bucket = 0; bucket < partition.paths.size(); bucket++)
+        {
+            // Equal lines always stay together, so a sub-bucket that keeps most of its parent is made of a few
+            // lines repeated many times, which the table stores only once: it is not split again
+            unsigned long long size = partition.sizes[bucket];
+            int nextLevel = size > bytes / 4 * 3 ? maxPartitionLevels : level + 1;
+            if (!findBucketDuplicates(state, partition.paths[bucket], size, nextLevel))
+                return false;
+        }
+        return true;
+    }
+
+    // Small enough: every line that is already in the table gives a link (first occurrence, line)
+    DistinctLineTable distinctLines;
+    bool written = true;
+    while (written && record.read(input))
+    {
+        long long firstOccurrence = distinctLines.insert(record.bytes.data(), record.bytes.size(), record.header[0], record.header[1]);
+        if (firstOccurrence != 0)
+        {
+            state.links.push_back({(long long)record.header[1], firstOccurrence});
+            if (state.links.size() >= state.linkCapacity)
+                written = writeLinkRun(state);
+        }
+    }
+    if (written && input.failed())
+        return state.readFailed(path);
+    input.close();
+    state.temporaries.remove(path);
+    return written;
+}
+
+// How many link runs one merge reads at the same time: each gets at least 64 KB of read buffer out of a
+// quarter of the budget (at least 2 runs, at most maxOpenTemporaryFiles)
+size_t mergeFanIn(size_t budget)
+{
+    return min(maxOpenTemporaryFiles, max<size_t>(2, budget / 4 / (1 << 16)));
+}
+
+// Merges the link runs in paths by (first occurrence, line) and gives every link, in that order, to emit,
+// which returns false to stop. The runs share a quarter of the budget as read buffers.
+// Returns false (with state.error) if a run could not be read or emit failed.
+template <class Emit>
+bool mergeLinkRuns(ReportState &state, const vector<string> &paths, Emit emit)
+{
+    size_t runCount = paths.size();
+    vector<BufferedFile> runs(runCount);
+    vector<DuplicatePair> heads(runCount);
+    auto later = [&](size_t left, size_t right)
+    {
+        if (heads[left].firstOccurrence != heads[right].firstOccurrence)
+            return heads[left].firstOccurrence > heads[right].firstOccurrence;
+        return heads[left].line > heads[right].line;
+    };
+    priority_queue<size_t, vector<size_t>, decltype(later)> pending(later);
+    for (size_t run = 0; run < runCount; run++)
+    {
+        if (!runs[run].open(paths[run], "rb", max<size_t>(4096, state.budget / 4 / runCount)))
+            return state.readFailed(paths[run]);
+        if (runs[run].read(&heads[run], sizeof(DuplicatePair)))
+            pending.push(run);
+        else if (runs[run].failed())
+            return state.readFailed(paths[run]);
+    }
+
+    while (!pending.empty())
+    {
+        size_t run = pending.top();
+        pending.pop();
+        if (!emit(heads[run]))
+            return false;
+        if (runs[run].read(&heads[run], sizeof(DuplicatePair)))
+            pending.push(run);
+        else if (runs[run].failed())
+            return state.readFailed(paths[run]);
+    }
+    return true;
+}
+
+// Reports every group of equal lines, not only the first duplicate, with memory bounded by
+// options.memoryMegabytes even if the file is much bigger than RAM. All the file accesses are sequential:
+//  1. Partition: the file is read once and every line is appended, with its hash and line number, to one of B
+//     bucket files chosen by the hash. Equal lines have equal hashes, so a group never spans two buckets.
+//     B is chosen from the file size so that one bucket fits in half of the budget.
+//  2. Each bucket is read back into a DistinctLineTable (the same one as the normal mode). Every line that
+//     is already in the table gives a link (first occurrence, line). The links are buffered in a quarter of
+//     the budget and written as sorted runs when the buffer is full. A bucket that is still too big (B is at
+//     most 128) is partitioned again with another hash seed before that, as many levels as needed.
+//  3. The runs are merged by (first occurrence, line), so the groups come out sorted by their first line,
+//     each one with its lines in increasing order. With more runs than mergeFanIn they are first merged in
+//     groups into longer runs (like externalMergeSort in Act 1.1), so the read buffers and the open files
+//     stay bounded however many runs there are.
+// Every temporary file is removed at the end, also when the report stops because of an error.
+// Returns false, with the reason in error, if a temporary file could not be written or read back.
+template <class Hasher>
+bool duplicateReport(istream &inputFile, const ScanOptions &options, string &error)
+{
+    size_t budget = (size_t)(options.memoryMegabytes * (1 << 20));
+    TemporaryFiles temporaries(options.temporaryDirectory);
+    ReportState state{budget, temporaries, {}, max<size_t>(1024, budget / 4 / sizeof(DuplicatePair)), {}, error};
+
+    inputFile.seekg(0, ios::end);
+    unsigned long long fileSize = max<long long>(0, (long long)inputFile.tellg());
+    inputFile.seekg(0, ios::beg);
+
+    // Phase 1: partition the lines
+    Partition partition(bucketBitsFor(fileSize, budget), 0);
+    if (!partition.open(temporaries, budget))
+        return state.writeFailed();
+    LineRecord record;
+    long long lineNumber = 0;
+    while (getline(inputFile, record.bytes))
+    {
+        lineNumber++;
+        record.header[0] = Hasher::hash(record.bytes.data(), record.bytes.size());
+        record.header[1] = lineNumber;
+        record.header[2] = record.bytes.size();
+        if (!partition.add(record))
+            return state.writeFailed();
+    }
+    if (!partition.close())
+        return state.writeFailed();
+
+    // Phase 2: find the duplicates of each bucket
+    for (size_t bucket = 0; bucket < partition.paths.size(); bucket++)
+        if (!findBucketDuplicates(state, partition.paths[bucket], partition.sizes[bucket], 1))
+            return false;
+    if (!state.links.empty() && !writeLinkRun(state))
+        return false;
+    vector<DuplicatePair>().swap(state.links); // give the link buffer back before merging
+
+    // Phase 3: merge the runs in groups of mergeFanIn until one merge is enough, then print the groups
+    size_t fanIn = mergeFanIn(budget);
+    while (state.runPaths.size() > fanIn)
+    {
+        vector<string> mergedPaths;
+        for (size_t start = 0; start < state.runPaths.size(); start += fanIn)
+        {
+            vector<string> group(state.runPaths.begin() + start, state.runPaths.begin() + min(state.runPaths.size(), start + fanIn));
+            mergedPaths.push_back(temporaries.create("links"));
+            BufferedFile output;
+            if (!output.open(mergedPaths.back(), "wb", max<size_t>(4096, budget / 4)))
+                return state.writeFailed();
+            if (!mergeLinkRuns(state, group, [&](const DuplicatePair &link)
+                               { return output.write(&link, sizeof(link)) || state.writeFailed(); }))
+                return false;
+            if (!output.close())
+                return state.writeFailed();
+            for (const string &path : group)
+                temporaries.remove(path);
+        }
+        state.runPaths = mergedPaths;
+    }
+
+    long long groupCount = 0, repeatedLines = 0, currentGroup = 0;
+    bool merged = mergeLinkRuns(state, state.runPaths, [&](const DuplicatePair &link)
+                                {
+                                    if (link.firstOccurrence != currentGroup)
+                                    {
+                                        if (currentGroup != 0)
+                                            cout << "\n";
+                                        currentGroup = link.firstOccurrence;
+                                        groupCount++;
+                                        cout << "Duplicate group: lines " << currentGroup;
+                                    }
+                                    cout << ", " << link.line;
+                                    repeatedLines++;
+                                    return true;
+                                });
+    if (!merged)
+        return false;
+    if (currentGroup != 0)
+        cout << "\n";
+
+    if (groupCount == 0)
+        cout << "All strings are distinct\n";
+    else
+        cout << "Strings are not distinct. Duplicate groups: " << groupCount
+             << ", lines that repeat an earlier one: " << repeatedLines << "\n";
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Longest repeated substring (rolling hash + binary search on the length)
+// ---------------------------------------------------------------------------
+
+// Finds the longest run of bytes that appears at least twice anywhere in the text (the two copies may
+// overlap, and newlines are bytes like the others).
+// If some substring of length L repeats, so does its prefix of length L - 1, so the answer can be searched
+// on L (doubling L first, then binary search, see find()), and each step only asks "is there a repeated
+// substring of exactly length L?":
+//  - A prefix-hash array modulo 2^61 - 1 (the same reduction as PolynomialHasher, with a random base) gives
+//    the hash of any substring in O(1):  hash(i, L) = prefix[i + L] - prefix[i] * base^L
+//  - A second polynomial hash modulo 2^32, with another base, is rolled along the windows ("double hashing").
+//  - The windows go into an open-addressing table indexed by the first hash. A slot keeps the start of the
+//    window and its second hash, so a probe only touches the slot itself; the first hash of a stored window
+//    is recomputed from the array only when the second hashes match, and then the bytes are compared too,
+//    so a repeat is never reported by mistake.
+//  - The slots are random memory accesses, so the hashes are computed a few windows ahead and their slots
+//    prefetched, to have several cache misses in flight at the same time.
+// That is O(n) expected per step and O(n log n) in total, with 8 bytes of prefix array per input byte plus
+// a table of 8-byte slots (at most 16 bytes per input byte).
+class LongestRepeatFinder
+{
+public:
+    struct Repeat
+    {
+        size_t length = 0;
+        size_t firstPosition = 0;
+        size_t secondPosition = 0;
+    };
+
+    LongestRepeatFinder(const char *text, size_t size) : text(text), size(size)
+    {
+        // Random bases, so no input can be built to collide on purpose (the answer is verified anyway)
+        unsigned long long seed = spreadHash((unsigned long long)chrono::steady_clock::now().time_since_epoch().count());
+        primaryBase = 256 + seed % (PolynomialHasher::modulus - 512);
+        secondaryBase = (unsigned int)(spreadHash(seed) | 1);
+
+        prefix.resize(size + 1);
+        for (size_t i = 0; i < size; i++)
+            prefix[i + 1] = PolynomialHasher::reduce((unsigned __int128)prefix[i] * primaryBase + byteValue(i));
+
+        size_t slotCount = 2;
+        while (slotCount * 3 < size * 4) // load factor at most 75%
+            slotCount *= 2;
+        slots.resize(slotCount);
+    }
+
+    Repeat find()
+    {
+        Repeat best;
+        if (size < 2)
+            return best;
+
+        // Double the length while it still repeats, then binary search between the last success and failure.
+        // Every repeat found is first extended as far as its bytes match on both sides, which often jumps
+        // straight to the answer (then the next check fails and the search is over).
+        size_t low = 1, high = size - 1;
+        bool doubling = true;
+        for (size_t length = 1; low <= high;)
+        {
+            Repeat found;
+            if (findRepeatOfLength(length, found))
+            {
+                extend(found);
+                best = found;
+                low = found.length + 1;
+                if (doubling)
+                    length = max(low, min(high, length * 2));
+            }
+            else
+            {
+                high = length - 1;
+                doubling = false;
+            }
+            if (!doubling)
+                length = low + (high - low) / 2;
+        }
+        return best;
+    }
+
+private:
+    static const size_t prefetchDistance = 32;
+
+    struct Window
+    {
+        unsigned long long primary;
+        unsigned int secondary;
+    };
+
+    unsigned int byteValue(size_t position) const { return (unsigned char)text[position] + 1; }
+
+    // Grows a repeat while the bytes before and after its two copies are still equal
+    void extend(Repeat &repeat) const
+    {
+        while (repeat.firstPosition > 0 && text[repeat.firstPosition - 1] == text[repeat.secondPosition - 1])
+        {
+            repeat.firstPosition--;
+            repeat.secondPosition--;
+            repeat.length++;
+        }
+        while (repeat.secondPosition + repeat.length < size &&
+               text[repeat.firstPosition + repeat.length] == text[repeat.secondPosition + repeat.length])
+            repeat.length++;
+    }
+
+    static unsigned long long power(unsigned long long base, size_t exponent)
+    {
+        unsigned long long result = 1;
+        for (; exponent > 0; exponent >>= 1)
+        {
+            if (exponent & 1)
+                result = PolynomialHasher::reduce((unsigned __int128)result * base);
+            base = PolynomialHasher::reduce((unsigned __int128)base * base);
+        }
+        return result;
+    }
+
+    unsigned long long primaryHash(size_t position, size_t length, unsigned long long basePower) const
+    {
+        unsigned long long shifted = PolynomialHasher::reduce((unsigned __int128)prefix[position] * basePower);
+        unsigned long long end = prefix[position + length];
+        return end >= shifted ? end - shifted : end + PolynomialHasher::modulus - shifted;
+    }
+
+    // Looks for two equal windows of the given length; the second one is the leftmost possible
+    bool findRepeatOfLength(size_t length, Repeat &found)
+    {
+        unsigned long long primaryPower = power(primaryBase, length);
+        unsigned int secondaryPower = 1; // secondaryBase^length, modulo 2^32 by overflow
+        for (size_t i = 0; i < length; i++)
+            secondaryPower *= secondaryBase;
+
+        fill(slots.begin(), slots.end(), 0);
+        size_t mask = slots.size() - 1;
+        size_t windowCount = size - length + 1;
+
+        unsigned int rolling = 0;
+        for (size_t i = 0; i < length; i++)
+            rolling = rolling * secondaryBase + byteValue(i);
+
+        Window ahead[prefetchDistance];
+        for (size_t next = 0; next < windowCount + prefetchDistance; next++)
+        {
+            // Insert the window from prefetchDistance steps before, whose slot should be in cache now...
+            if (next >= prefetchDistance)
+            {
+                size_t position = next - prefetchDistance;
+                const Window &window = ahead[position % prefetchDistance];
+                for (size_t slot = window.primary & mask;; slot = (slot + 1) & mask)
+                {
+                    if (slots[slot] == 0)
+                    {
+                        slots[slot] = (unsigned long long)window.secondary << 32 | (position + 1); // 0 = empty
+                        break;
+                    }
+                    size_t earlier = (slots[slot] & 0xffffffffu) - 1;
+                    if ((unsigned int)(slots[slot] >> 32) == window.secondary &&
+                        primaryHash(earlier, length, primaryPower) == window.primary &&
+                        memcmp(text + earlier, text + position, length) == 0)
+                    {
+                        found = {length, earlier, position};
+                        return true;
+                    }
+                }
+            }
+
+            // ...then hash window "next" into the freed entry and prefetch its slot
+            if (next < windowCount)
+            {
+                Window &window = ahead[next % prefetchDistance];
+                window.primary = primaryHash(next, length, primaryPower);
+                window.secondary = rolling;
+                __builtin_prefetch(&slots[window.primary & mask]);
+                if (next + 1 < windowCount)
+                    rolling = rolling * secondaryBase - byteValue(next) * secondaryPower + byteValue(next + length);
+            }
+        }
+        return false;
+    }
+
+    const char *text;
+    size_t size;
+    unsigned long long primaryBase;
+    unsigned int secondaryBase;
+    vector<unsigned long long> prefix;
+    vector<unsigned long long> slots; // second hash << 32 | (window start + 1), 0 = empty
+};
+
+// Prints the longest repeated substring of a file, where its two copies start (byte offset and line), and
+// the substring itself (escaped and cut to 200 bytes)
+int printLongestRepeat(const char *fileName)
+{
+    MappedFile mappedFile(fileName);
+    if (!mappedFile.isOpen())
+    {
+        cerr << "Error: Could not open file " << fileName << "\n";
+        return 1;
+    }
+    if (mappedFile.size() >= 0xffffffffu)
+    {
+        cerr << "Error: --longest-repeat supports files of up to 4 GB\n";
+        return 1;
+    }
+
+    LongestRepeatFinder finder(mappedFile.data(), mappedFile.size());
+    LongestRepeatFinder::Repeat repeat = finder.find();
+    if (repeat.length == 0)
+    {
+        cout << "No substring appears twice\n";
+        return 0;
+    }
+
+    auto lineOf = [&](size_t position)
+    { return 1 + count(mappedFile.data(), mappedFile.data() + position, '\n'); };
+    cout << "Longest repeated substring: " << repeat.length << " bytes, at byte " << repeat.firstPosition << " (line "
+         << lineOf(repeat.firstPosition) << ") and at byte " << repeat.secondPosition << " (line "
+         << lineOf(repeat.secondPosition) << ")\n";
+
+    string shown;
+    for (size_t i = 0; i < min<size_t>(repeat.length, 200); i++)
+    {
+        char byte = mappedFile.data()[repeat.firstPosition + i];
+        if (byte == '\n')
+            shown += "\\n";
+        else if (byte == '\\')
+            shown += "\\\\";
+        else if ((unsigned char)byte < 32 || byte == 127)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\x%02x", (unsigned char)byte);
+            shown += escaped;
+        }
+        else
+            shown += byte;
+    }
+    cout << "\"" << shown << (repeat.length > 200 ? "\"..." : "\"") << "\n";
+    return 0;
+}
+
+// Runs the check on a file with the chosen hasher (threadCount = 0 for the getline loop, or one of the
+// bounded-memory modes) and prints the result
+template <class Hasher>
+int checkFile(const char *fileName, int threadCount, const ScanOptions &options)
+{
+    DuplicatePair duplicate;
+    if (options.report)
+    {
+        ifstream inputFile(fileName, ios::binary);
+        if (!inputFile.is_open())
+        {
+            cerr << "Error: Could not open file " << fileName << "\n";
+            return 1;
+        }
+        string error;
+        if (!duplicateReport<Hasher>(inputFile, options, error))
+        {
+            cerr << "Error: " << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    else if (options.approximate)
+    {
+        // "-" reads stdin; verification has to read the input again, so it needs a real file
+        if (string(fileName) == "-")
+        {
+            if (options.verifyPasses > 0)
+            {
+                cerr << "Error: --verify needs a file that can be read again, not stdin\n";
+                return 1;
+            }
+            return approximateDuplicateScan<Hasher>(fileName, cin, options);
+        }
+        ifstream inputFile(fileName);
+        if (!inputFile.is_open())
+        {
+            cerr << "Error: Could not open file " << fileName << "\n";
+            return 1;
+        }
+        return approximateDuplicateScan<Hasher>(fileName, inputFile, options);
+    }
+    else if (threadCount > 0)
+    {
+        MappedFile mappedFile(fileName);
+        if (!mappedFile.isOpen())
+        {
+            cerr << "Error: Could not open file " << fileName << "\n";
+            return 1;
+        }
+        duplicate = parallelDuplicateScan<Hasher>(mappedFile.data(), mappedFile.size(), threadCount);
+    }
+    else
+    {
+        // Open the file
+        ifstream inputFile(fileName);
+
+        // Check if file is open
+        if (!inputFile.is_open())
+        {
+            cerr << "Error: Could not open file " << fileName << "\n";
+            return 1;
+        }
+        duplicate = sequentialDuplicateScan<Hasher>(inputFile);
+    }
+
+    if (duplicate.line != 0)
+        cout << "Strings are not distinct. Duplicate found at line " << duplicate.line
+             << ". First occurrence was at line " << duplicate.firstOccurrence << ".\n";
+    else
+        // If we reach here, all strings are distinct
+        cout << "All strings are distinct\n";
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Hash microbenchmark
+// ---------------------------------------------------------------------------
+
+// Hashes the same buffer as lines of lineLength bytes, over and over, and prints the speed in GB/s.
+// The hashes are added into a checksum that is printed, so the compiler cannot remove the calls.
+template <class Hasher>
+void benchmarkHasher(const vector<char> &buffer, size_t lineLength)
+{
+    size_t lineCount = buffer.size() / lineLength;
+    int repetitions = 0;
+    unsigned long long checksum = 0;
+    auto start = chrono::steady_clock::now();
+    double seconds = 0;
+    do
+    {
+        for (size_t line = 0; line < lineCount; line++)
+            checksum += Hasher::hash(buffer.data() + line * lineLength, lineLength);
+        repetitions++;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.2);
+
+    double bytes = (double)lineCount * lineLength * repetitions;
+    cout << "  " << Hasher::name << string(8 - strlen(Hasher::name), ' ') << fixed << setprecision(2)
+         << bytes / seconds / 1e9 << " GB/s  " << (double)lineCount * repetitions / seconds / 1e6
+         << " Mlines/s  (checksum " << hex << (checksum & 0xffff) << dec << ")\n";
+}
+
+void runHashBenchmark()
+{
+    // 4 MB of random bytes: fits in L2/L3, so the numbers measure the hash and not the memory
+    vector<char> buffer(4 << 20);
+    unsigned long long state = 88172645463325252ull;
+    for (char &byte : buffer)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = (char)state;
+    }
+
+    cout << "CRC32C: " << (cpuHasSse42 ? "SSE4.2 instruction" : "lookup table") << "\n";
+    for (size_t lineLength : {8, 24, 64, 256, 4096})
+    {
+        cout << "Lines of " << lineLength << " bytes:\n";
+        benchmarkHasher<PolynomialHasher>(buffer, lineLength);
+        benchmarkHasher<Fnv1aHasher>(buffer, lineLength);
+        benchmarkHasher<MultiplyMixHasher>(buffer, lineLength);
+        benchmarkHasher<Crc32cHasher>(buffer, lineLength);
+    }
+}
+
+int main(int argumentCount, char *argumentValues[])
+{
+    if (argumentCount == 2 && string(argumentValues[1]) == "--hashbench")
+    {
+        runHashBenchmark();
+        return 0;
+    }
+
+    // Check if file name is provided
+    const char *fileName = nullptr;
+    int threadCount = 0; // 0 = sequential getline loop
+    string hashName = MultiplyMixHasher::name;
+    ScanOptions options;
+    bool longestRepeat = false;
+    bool validArguments = true;
+    for (int i = 1; i < argumentCount; i++)
+    {
+        string flag = argumentValues[i];
+        if (flag == "--threads" && i + 1 < argumentCount)
+        {
+            threadCount = atoi(argumentValues[++i]);
+            if (threadCount < 1)
+                validArguments = false;
+        }
+        else if (flag == "--hash" && i + 1 < argumentCount)
+            hashName = argumentValues[++i];
+        else if (flag == "--approximate")
+            options.approximate = true;
+        else if (flag == "--report")
+            options.report = true;
+        else if (flag == "--longest-repeat")
+            longestRepeat = true;
+        else if (flag == "--tmpdir" && i + 1 < argumentCount)
+            options.temporaryDirectory = argumentValues[++i];
+        else if (flag == "--memory" && i + 1 < argumentCount)
+            options.memoryMegabytes = atof(argumentValues[++i]);
+        else if (flag == "--fp" && i + 1 < argumentCount)
+            options.falsePositiveRate = atof(argumentValues[++i]);
+        else if (flag == "--verify" && i + 1 < argumentCount)
+        {
+            options.verifyPasses = atoi(argumentValues[++i]);
+            if (options.verifyPasses < 1)
+                validArguments = false;
+        }
+        else if (fileName == nullptr && flag.compare(0, 2, "--") != 0)
+            fileName = argumentValues[i];
+        else
+            validArguments = false;
+    }
+    if (hashName != PolynomialHasher::name && hashName != Fnv1aHasher::name && hashName != MultiplyMixHasher::name &&
+        hashName != Crc32cHasher::name)
+        validArguments = false;
+    if (options.memoryMegabytes <= 0 || options.falsePositiveRate <= 0 || options.falsePositiveRate >= 1)
+        validArguments = false;
+    if (fileName == nullptr || !validArguments)
+    {
+        cerr << "Usage: " << argumentValues[0] << " <input_file> [--threads T] [--hash poly|fnv|wymix|crc32c]\n"
+             << "       " << argumentValues[0] << " <input_file | -> --approximate [--memory MB] [--fp rate] [--verify K] [--hash ...]\n"
+             << "       " << argumentValues[0] << " <input_file> --report [--memory MB] [--tmpdir dir] [--hash ...]\n"
+             << "       " << argumentValues[0] << " <input_file> --longest-repeat\n"
+             << "       " << argumentValues[0] << " --hashbench\n";
+        return 1;
+    }
+
+    // Indicate which file is being processed
+    cout << "Processing file: " << fileName << endl;
+
+    // --longest-repeat looks at substrings, not lines, so the hash and the scan modes don't apply to it
+    if (longestRepeat)
+        return printLongestRepeat(fileName);
+
+    if (hashName == PolynomialHasher::name)
+        return checkFile<PolynomialHasher>(fileName, threadCount, options);
+    if (hashName == Fnv1aHasher::name)
+        return checkFile<Fnv1aHasher>(fileName, threadCount, options);
+    if (hashName == Crc32cHasher::name)
+        return checkFile<Crc32cHasher>(fileName, threadCount, options);
+    return checkFile<MultiplyMixHasher>(fileName, threadCount, options);
+}
@@ -2,6 +2,22 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -67,6 +83,402 @@ int KMP(const string &text, const string &pattern)
     return -1; // No match found
 }
 
+// KMP that keeps its state between calls, so the text can be given in pieces (for example, file blocks)
+// and the matches are reported with their offset from the beginning of the whole text.
+// The LPS table is built once in the constructor.
+class StreamingKMP
+{
+public:
+    explicit StreamingKMP(const string &pattern) : pattern(pattern), lps(pattern.size(), 0)
+    {
+        // Build the LPS array (longest-prefix-suffix), same as in KMP()
+        int m = pattern.size();
+        for (int i = 1, length = 0; i < m;)
+        {
+            if (pattern[i] == pattern[length])
+            {
+                lps[i++] = ++length;
+            }
+            else if (length)
+            {
+                length = lps[length - 1];
+            }
+            else
+            {
+                lps[i++] = 0;
+            }
+        }
+    }
+
+    // Feeds the next piece of the text and calls report(offset) for every match that ends in it.
+    // Matches may overlap (after a match the search goes on from lps of the whole pattern).
+    template <class Report>
+    void feed(const char *data, size_t size, Report report)
+    {
+        int m = pattern.size();
+        if (m == 0)
+        {
+            if (!reportedEmpty)
+                report(0LL); // Immediate match if pattern is empty, like KMP()
+            reportedEmpty = true;
+            return;
+        }
+        for (size_t i = 0; i < size; i++)
+        {
+            while (k && data[i] != pattern[k])
+            {
+                k = lps[k - 1];
+            }
+            if (data[i] == pattern[k])
+            {
+                k++;
+            }
+            if (k == m)
+            {
+                report(offset + (long long)i + 1 - m);
+                k = lps[k - 1];
+            }
+        }
+        offset += size;
+    }
+
+private:
+    string pattern;
+    vector<int> lps;
+    int k = 0;            // characters of the pattern matched so far
+    long long offset = 0; // characters of the text fed so far
+    bool reportedEmpty = false;
+};
+
+// Streams a file through a StreamingKMP with a fixed-size buffer, so the memory does not depend on the file
+// size. The newlines are skipped, so the offsets are the same as in the string returned by readFromFile.
+// Returns false if the file could not be opened.
+template <class Report>
+bool streamSearch(const string &filePath, StreamingKMP &matcher, Report report, size_t bufferSize = 1 << 20)
+{
+    ifstream file(filePath, ios::binary);
+    if (!file.is_open())
+        return false;
+
+    vector<char> buffer(bufferSize);
+    matcher.feed(buffer.data(), 0, report); // empty pattern: reported even if the file is empty
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        size_t got = file.gcount();
+        // Feed the runs between newlines
+        const char *begin = buffer.data(), *end = buffer.data() + got;
+        while (begin < end)
+        {
+            const char *newline = (const char *)memchr(begin, '\n', end - begin);
+            const char *stop = newline ? newline : end;
+            matcher.feed(begin, stop - begin, report);
+            begin = newline ? newline + 1 : end;
+        }
+    }
+    return true;
+}
+
+// Searches the text with threadCount threads. The text is cut into one chunk per thread, and each thread
+// runs its own StreamingKMP from the start of its chunk until pattern length - 1 bytes past its end, so a
+// match that crosses the border between two chunks is still seen. A match is kept only by the chunk where
+// it starts, which removes the duplicates that the overlap would create, and since the chunks are in order,
+// putting their lists one after the other gives all the positions sorted.
+// With firstOnly, only the first match is returned (the same as KMP()): every thread stops at its first
+// match, and also stops early once a chunk before it has found one, because then its matches cannot be first.
+vector<long long> parallelSearch(const string &text, const string &pattern, int threadCount, bool firstOnly)
+{
+    if (pattern.empty())
+        return {0}; // Immediate match if pattern is empty, like KMP()
+
+    const size_t blockSize = 1 << 16; // how often a thread checks if it can stop
+    size_t n = text.size(), m = pattern.size();
+    size_t chunkSize = max<size_t>(1, (n + threadCount - 1) / threadCount);
+    vector<vector<long long>> found(threadCount);
+    atomic<long long> firstFound(LLONG_MAX);
+
+    vector<thread> threads;
+    for (int t = 0; t < threadCount && (size_t)t * chunkSize < n; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            size_t start = t * chunkSize;
+            size_t end = min(n, start + chunkSize);
+            size_t scanEnd = min(n, end + m - 1);
+            StreamingKMP matcher(pattern);
+            bool done = false;
+            for (size_t position = start; position < scanEnd && !done; position += blockSize)
+            {
+                if (firstOnly && firstFound.load() < (long long)start)
+                    break;
+                matcher.feed(text.data() + position, min(blockSize, scanEnd - position), [&](long long offset)
+                {
+                    long long at = (long long)start + offset;
+                    if (done || at >= (long long)end)
+                        return; // starts in the next chunk, that thread reports it
+                    found[t].push_back(at);
+                    if (firstOnly)
+                    {
+                        long long best = firstFound.load();
+                        while (at < best && !firstFound.compare_exchange_weak(best, at))
+                        {
+                        }
+                        done = true;
+                    }
+                });
+            }
+        });
+    }
+    for (thread &worker : threads)
+        worker.join();
+
+    vector<long long> positions;
+    for (const vector<long long> &chunkPositions : found)
+    {
+        positions.insert(positions.end(), chunkPositions.begin(), chunkPositions.end());
+        if (firstOnly && !positions.empty())
+            break;
+    }
+    return positions;
+}
+
+// Same result as KMP(text, pattern), using threadCount threads
+long long parallelKMP(const string &text, const string &pattern, int threadCount)
+{
+    vector<long long> positions = parallelSearch(text, pattern, threadCount, true);
+    return positions.empty() ? -1 : positions[0];
+}
+
+// SIMD prefilter search: a position can only start a match if the text has the first byte of the pattern
+// there and the last byte of the pattern m - 1 bytes later. Both tests are done for 32 positions at once
+// (16 with SSE2) with two vector compares, and only the positions that pass both are checked with memcmp.
+// On text where the first/last pair is rare this skips almost every position after a couple of instructions.
+// report(position) is called for every match in increasing order (overlapping matches included); it returns
+// false to stop the search.
+template <class Report>
+bool scalarPrefilterSearch(const char *text, size_t n, const string &pattern, size_t from, Report &report)
+{
+    size_t m = pattern.size();
+    for (size_t i = from; i + m <= n; ++i)
+    {
+        if (text[i] == pattern[0] && text[i + m - 1] == pattern[m - 1] && memcmp(text + i, pattern.data(), m) == 0 &&
+            !report((long long)i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// Checks the candidates in one mask (bit k = position i + k passed the prefilter)
+template <class Report>
+inline bool verifyCandidates(const char *text, size_t i, unsigned mask, const string &pattern, Report &report)
+{
+    size_t m = pattern.size();
+    while (mask)
+    {
+        size_t position = i + __builtin_ctz(mask);
+        if ((m <= 2 || memcmp(text + position + 1, pattern.data() + 1, m - 2) == 0) && !report((long long)position))
+        {
+            return false;
+        }
+        mask &= mask - 1;
+    }
+    return true;
+}
+
+template <class Report>
+__attribute__((target("avx2"))) bool avx2PrefilterSearch(const char *text, size_t n, const string &pattern, Report &report)
+{
+    size_t m = pattern.size();
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+    size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i blockLast = _mm256_loadu_si256((const __m256i *)(text + i + m - 1));
+        __m256i both = _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast));
+        if (!verifyCandidates(text, i, (unsigned)_mm256_movemask_epi8(both), pattern, report))
+        {
+            return false;
+        }
+    }
+    return scalarPrefilterSearch(text, n, pattern, i, report);
+}
+
+template <class Report>
+__attribute__((target("sse2"))) bool sse2PrefilterSearch(const char *text, size_t n, const string &pattern, Report &report)
+{
+    size_t m = pattern.size();
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i blockLast = _mm_loadu_si128((const __m128i *)(text + i + m - 1));
+        __m128i both = _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast));
+        if (!verifyCandidates(text, i, (unsigned)_mm_movemask_epi8(both), pattern, report))
+        {
+            return false;
+        }
+    }
+    return scalarPrefilterSearch(text, n, pattern, i, report);
+}
+
+const bool cpuHasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+
+template <class Report>
+void simdSearch(const string &text, const string &pattern, Report report)
+{
+    if (pattern.empty())
+    {
+        report(0LL); // Immediate match if pattern is empty, like KMP()
+        return;
+    }
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (cpuHasAvx2)
+    {
+        avx2PrefilterSearch(text.data(), text.size(), pattern, report);
+    }
+    else
+    {
+        sse2PrefilterSearch(text.data(), text.size(), pattern, report);
+    }
+#else
+    scalarPrefilterSearch(text.data(), text.size(), pattern, 0, report);
+#endif
+}
+
+// Same result as KMP(text, pattern): stops at the first match
+long long simdFind(const string &text, const string &pattern)
+{
+    long long found = -1;
+    simdSearch(text, pattern, [&](long long position)
+               { found = position; return false; });
+    return found;
+}
+
+// Aho-Corasick automaton: finds every occurrence of many patterns in one pass over the text.
+// The patterns are put in a trie, and every state gets a failure link (the longest proper suffix of the
+// state that is also a trie state). The failure links are then folded into the transitions, so the scan is a
+// plain DFA: one table lookup per text byte, no matter how many patterns there are.
+// The transition table is one flat array, transitions[state * classCount + class]. Only the bytes that
+// appear in some pattern get their own class; every other byte is class 0, which always goes back to the
+// root. With a few thousand short signatures this keeps the table small enough to stay in cache.
+class AhoCorasick
+{
+public:
+    explicit AhoCorasick(const vector<string> &patterns) : patternLength(patterns.size()), nextOutput(patterns.size(), -1)
+    {
+        // Byte classes
+        fill(begin(byteClass), end(byteClass), 0);
+        classCount = 1;
+        for (const string &pattern : patterns)
+            for (unsigned char c : pattern)
+                if (byteClass[c] == 0)
+                    byteClass[c] = classCount++;
+
+        // Trie (-1 = no edge yet)
+        addState();
+        for (int p = 0; p < (int)patterns.size(); p++)
+        {
+            patternLength[p] = patterns[p].size();
+            if (patterns[p].empty())
+            {
+                emptyPatterns.push_back(p);
+                continue;
+            }
+            int state = 0;
+            for (unsigned char c : patterns[p])
+            {
+                int &next = transitions[(size_t)state * classCount + byteClass[c]];
+                if (next == -1)
+                {
+                    int created = addState();
+                    transitions[(size_t)state * classCount + byteClass[c]] = created; // addState may have moved the table
+                    state = created;
+                }
+                else
+                    state = next;
+            }
+            nextOutput[p] = firstOutput[state];
+            firstOutput[state] = p;
+        }
+
+        // Failure links in BFS order (a state's link is always shallower, so it is finished before it)
+        vector<int> failure(stateCount, 0);
+        vector<int> queue;
+        for (int c = 0; c < classCount; c++)
+        {
+            int &next = transitions[c];
+            if (next == -1)
+                next = 0;
+            else
+                queue.push_back(next);
+        }
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            int state = queue[head];
+            outputLink[state] = firstOutput[failure[state]] != -1 ? failure[state] : outputLink[failure[state]];
+            for (int c = 0; c < classCount; c++)
+            {
+                int &next = transitions[state * classCount + c];
+                int fallback = transitions[failure[state] * classCount + c];
+                if (next == -1)
+                    next = fallback;
+                else
+                {
+                    failure[next] = fallback;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    // Calls report(patternIndex, startPosition) for every occurrence of every pattern, in order of the
+    // position where the occurrence ends. An empty pattern is reported once, at position 0 (like KMP()).
+    template <class Report>
+    void scan(const string &text, Report report) const
+    {
+        for (int p : emptyPatterns)
+            report(p, 0);
+
+        const int *table = transitions.data();
+        int state = 0;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            state = table[state * classCount + byteClass[(unsigned char)text[i]]];
+            // Walk the chain of states with outputs: this state (if it has any), then its output links
+            for (int output = firstOutput[state] != -1 ? state : outputLink[state]; output != -1; output = outputLink[output])
+                for (int p = firstOutput[output]; p != -1; p = nextOutput[p])
+                    report(p, (int)(i + 1 - patternLength[p]));
+        }
+    }
+
+private:
+    int addState()
+    {
+        transitions.insert(transitions.end(), classCount, -1);
+        firstOutput.push_back(-1);
+        outputLink.push_back(-1);
+        return stateCount++;
+    }
+
+    unsigned char byteClass[256];
+    int classCount;
+    int stateCount = 0;
+    vector<int> transitions;   // stateCount x classCount
+    vector<int> firstOutput;   // per state: a pattern that ends here (-1 = none)
+    vector<int> outputLink;    // per state: nearest state on the failure chain with an output (-1 = none)
+    vector<int> patternLength; // per pattern
+    vector<int> nextOutput;    // per pattern: another pattern that ends at the same state (-1 = none)
+    vector<int> emptyPatterns;
+};
+
 // Manacher's algorithm to find the longest palindromic substring
 pair<int, int> findLongestPalindrome(const string &s)
 {
@@ -144,6 +556,257 @@ pair<int, int> longestCommonSubstring(const string &s1, const string &s2)
     return make_pair(endAt - maxLength + 1, endAt); // Adjust to 1-based indexing
 }
 
+// Suffix automaton of a string: the smallest DFA that accepts all its substrings. It has at most 2n states
+// and is built online in O(n). Every state is a set of substrings that end at the same positions; length is
+// the longest one, link (the suffix link) goes to the state of the longest suffix that ends in more
+// positions, and firstEnd is where the first occurrence of the state's substrings ends.
+// With a small alphabet (hex transmissions) the transitions are a dense table over the bytes that appear in
+// the string (like AhoCorasick), one row per state: one memory access per step instead of walking an edge
+// list, for 4 bytes per state and per distinct byte (about 128 bytes per input byte for hex). With more than
+// denseClassLimit distinct bytes (binary captures) that table would grow to about 2 KB per input byte, so
+// each state keeps a list of its edges instead (at most 3n edges in all), and only the states that reach
+// wideEdgeLimit edges, which are few and close to the root, get a dense row. About 60 bytes per input byte
+// for random binary data.
+class SuffixAutomaton
+{
+public:
+    static const int denseClassLimit = 32;
+    static const int wideEdgeLimit = 8;
+
+    explicit SuffixAutomaton(const string &s)
+    {
+        fill(begin(byteClass), end(byteClass), -1); // -1 = byte not in the string
+        for (unsigned char c : s)
+            if (byteClass[c] == -1)
+                byteClass[c] = classCount++;
+        dense = classCount <= denseClassLimit;
+
+        length.reserve(2 * s.size() + 1);
+        if (dense)
+            transitions.reserve((2 * s.size() + 1) * classCount);
+        else
+            edges.reserve(3 * s.size());
+        addState(0, -1, -1);
+        int last = 0;
+        for (int i = 0; i < (int)s.size(); ++i)
+        {
+            int c = byteClass[(unsigned char)s[i]];
+            int cur = addState(length[last] + 1, -1, i);
+            int p = last;
+            while (p != -1 && transition(p, c) == -1)
+            {
+                setTransition(p, c, cur);
+                p = link[p];
+            }
+            if (p == -1)
+            {
+                link[cur] = 0;
+            }
+            else
+            {
+                int q = transition(p, c);
+                if (length[p] + 1 == length[q])
+                {
+                    link[cur] = q;
+                }
+                else
+                {
+                    // Split q: the clone keeps the shorter strings, which now also end at i
+                    int clone = addState(length[p] + 1, link[q], firstEnd[q]);
+                    copyTransitions(q, clone);
+                    while (p != -1 && transition(p, c) == q)
+                    {
+                        setTransition(p, c, clone);
+                        p = link[p];
+                    }
+                    link[q] = link[cur] = clone;
+                }
+            }
+            last = cur;
+        }
+    }
+
+    int stateCount() const { return length.size(); }
+
+    // Transition from state with byte c, or -1
+    int next(int state, unsigned char c) const
+    {
+        return byteClass[c] == -1 ? -1 : transition(state, byteClass[c]);
+    }
+
+    vector<int> length, link, firstEnd;
+
+private:
+    struct Edge
+    {
+        int byteClass;
+        int target;
+        int nextEdge; // next edge of the same state, -1 = last
+    };
+
+    int addState(int stateLength, int stateLink, int stateFirstEnd)
+    {
+        length.push_back(stateLength);
+        link.push_back(stateLink);
+        firstEnd.push_back(stateFirstEnd);
+        if (dense)
+            transitions.insert(transitions.end(), classCount, -1);
+        else
+        {
+            firstEdge.push_back(-1);
+            wideRow.push_back(-1);
+            edgeCount.push_back(0);
+        }
+        return length.size() - 1;
+    }
+
+    // Transition from state with byte class c, or -1
+    int transition(int state, int c) const
+    {
+        if (dense)
+            return transitions[(size_t)state * classCount + c];
+        if (wideRow[state] != -1)
+            return transitions[(size_t)wideRow[state] * classCount + c];
+        for (int e = firstEdge[state]; e != -1; e = edges[e].nextEdge)
+            if (edges[e].byteClass == c)
+                return edges[e].target;
+        return -1;
+    }
+
+    void setTransition(int state, int c, int target)
+    {
+        if (dense)
+        {
+            transitions[(size_t)state * classCount + c] = target;
+            return;
+        }
+        if (wideRow[state] != -1)
+        {
+            transitions[(size_t)wideRow[state] * classCount + c] = target;
+            return;
+        }
+        for (int e = firstEdge[state]; e != -1; e = edges[e].nextEdge)
+        {
+            if (edges[e].byteClass == c)
+            {
+                edges[e].target = target;
+                return;
+            }
+        }
+        edges.push_back({c, target, firstEdge[state]});
+        firstEdge[state] = edges.size() - 1;
+        if (++edgeCount[state] == wideEdgeLimit)
+        {
+            wideRow[state] = transitions.size() / classCount;
+            transitions.insert(transitions.end(), classCount, -1);
+            for (int e = firstEdge[state]; e != -1; e = edges[e].nextEdge)
+                transitions[(size_t)wideRow[state] * classCount + edges[e].byteClass] = edges[e].target;
+        }
+    }
+
+    // Gives to (a new state) the same transitions as from
+    void copyTransitions(int from, int to)
+    {
+        if (dense)
+        {
+            copy(transitions.begin() + (size_t)from * classCount, transitions.begin() + (size_t)(from + 1) * classCount,
+                 transitions.begin() + (size_t)to * classCount);
+            return;
+        }
+        if (wideRow[from] != -1)
+        {
+            for (int c = 0; c < classCount; c++)
+                if (transitions[(size_t)wideRow[from] * classCount + c] != -1)
+                    setTransition(to, c, transitions[(size_t)wideRow[from] * classCount + c]);
+            return;
+        }
+        for (int e = firstEdge[from]; e != -1; e = edges[e].nextEdge)
+            setTransition(to, edges[e].byteClass, edges[e].target);
+    }
+
+    int byteClass[256];
+    int classCount = 0;
+    bool dense;
+    vector<int> transitions; // dense: stateCount x classCount; sparse: the rows of the wide states. -1 = no transition
+    vector<int> firstEdge;   // sparse: first edge of each state in edges, -1 = none
+    vector<int> edgeCount;   // sparse: number of edges of each state
+    vector<int> wideRow;     // sparse: row of the state in transitions once it has wideEdgeLimit edges, else -1
+    vector<Edge> edges;
+};
+
+// Longest substring common to all the texts, in O(total length) time and memory, with the same result as
+// longestCommonSubstring for two texts: 1-based start and end in texts[0], at the first place in texts[0]
+// where a longest common substring ends ((1, 0) if there is none).
+// The automaton is built on texts[0] and every other text is streamed through it, keeping the longest
+// match that ends at each state. A match at a state also matches the whole of its suffix link, so that is
+// pushed up the links (longest states first), and each state keeps the minimum over the texts.
+pair<int, int> longestCommonSubstringK(const vector<string> &texts)
+{
+    if (texts.empty())
+        return make_pair(1, 0);
+
+    SuffixAutomaton automaton(texts[0]);
+    int states = automaton.stateCount();
+    vector<int> common(automaton.length); // longest part of each state common to every text so far
+
+    // States sorted by decreasing length (counting sort), so a state comes before its suffix link
+    vector<int> byLength(states), counts(texts[0].size() + 2, 0);
+    for (int v = 0; v < states; ++v)
+        counts[automaton.length[v]]++;
+    for (size_t l = 1; l < counts.size(); ++l)
+        counts[l] += counts[l - 1];
+    for (int v = states - 1; v >= 0; --v)
+        byLength[--counts[automaton.length[v]]] = v;
+    reverse(byLength.begin(), byLength.end());
+
+    vector<int> matched(states);
+    for (size_t t = 1; t < texts.size(); ++t)
+    {
+        fill(matched.begin(), matched.end(), 0);
+        int v = 0, l = 0;
+        for (unsigned char c : texts[t])
+        {
+            while (v != 0 && automaton.next(v, c) == -1)
+            {
+                v = automaton.link[v];
+                l = automaton.length[v];
+            }
+            int target = automaton.next(v, c);
+            if (target != -1)
+            {
+                v = target;
+                l++;
+            }
+            matched[v] = max(matched[v], l);
+        }
+        for (int u : byLength)
+        {
+            int parent = automaton.link[u];
+            if (parent != -1 && matched[u] > 0)
+                matched[parent] = automaton.length[parent];
+            common[u] = min(common[u], matched[u]);
+        }
+    }
+
+    int maxLength = 0, endAt = 0; // endAt: 1-based, like longestCommonSubstring
+    for (int u = 1; u < states; ++u)
+    {
+        int end = automaton.firstEnd[u] + 1;
+        if (common[u] > maxLength || (common[u] == maxLength && maxLength > 0 && end < endAt))
+        {
+            maxLength = common[u];
+            endAt = end;
+        }
+    }
+    return make_pair(endAt - maxLength + 1, endAt);
+}
+
+// Same result as longestCommonSubstring, in linear time and memory instead of an (n1+1) x (n2+1) table
+pair<int, int> longestCommonSubstringSAM(const string &s1, const string &s2)
+{
+    return longestCommonSubstringK({s1, s2});
+}
+
 // ANSI color codes
 const string RED = "\033[31m";
 const string GREEN = "\033[32m";
@@ -151,37 +814,696 @@ const string YELLOW = "\033[33m";
 const string MAGENTA = "\033[1;35m";
 const string RESET = "\033[0m";
 
-int main()
+// Prints the result of one (transmission, mcode) pair. The positions come one by one and in increasing
+// order, so nothing has to be stored (only the first one, to know if it is "position" or "positions").
+class OccurrencePrinter
+{
+public:
+    OccurrencePrinter(int transmission, int mcode)
+    {
+        cout << "Transmission " << transmission << " - mcode " << mcode << ": ";
+    }
+
+    void add(long long position)
+    {
+        if (count == 1)
+        {
+            cout << GREEN << "true " << RESET << GREEN << " at positions " << first + 1; // Output is 1-based index
+        }
+        if (count >= 1)
+        {
+            cout << ", " << position + 1;
+        }
+        else
+        {
+            first = position;
+        }
+        count++;
+    }
+
+    void finish()
+    {
+        if (count == 0)
+        {
+            cout << RED << "false" << RESET;
+        }
+        else if (count == 1)
+        {
+            cout << GREEN << "true " << RESET << GREEN << " at position " << first + 1 << RESET;
+        }
+        else
+        {
+            cout << RESET;
+        }
+        cout << endl;
+    }
+
+private:
+    long long first = -1;
+    long long count = 0;
+};
+
+// Suffix array of s (values in [0, upper]) with SA-IS, in linear time. The L/S types and the sorted LMS
+// suffixes induce the order of all the others; if two LMS substrings are equal the LMS suffixes are named by
+// their LMS substring and sorted by recursing on the shorter string of names.
+vector<int> suffixArrayIS(const vector<int> &s, int upper)
+{
+    int n = s.size();
+    if (n == 0)
+        return {};
+    if (n == 1)
+        return {0};
+    if (n == 2)
+        return s[0] < s[1] ? vector<int>{0, 1} : vector<int>{1, 0};
+
+    vector<int> sa(n);
+    vector<bool> isS(n, false); // S-type: smaller than the suffix after it (the last one is L-type)
+    for (int i = n - 2; i >= 0; --i)
+    {
+        isS[i] = s[i] == s[i + 1] ? isS[i + 1] : s[i] < s[i + 1];
+    }
+
+    // Start of the S part and of the L part of each bucket
+    vector<int> startS(upper + 1, 0), startL(upper + 1, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        if (!isS[i])
+            startS[s[i]]++;
+        else
+            startL[s[i] + 1]++;
+    }
+    for (int c = 0; c <= upper; ++c)
+    {
+        startS[c] += startL[c];
+        if (c < upper)
+            startL[c + 1] += startS[c];
+    }
+
+    // Places the LMS suffixes (in the given order) at the ends of their buckets, then induces the L-type
+    // suffixes left to right and the S-type suffixes right to left
+    auto induce = [&](const vector<int> &lms)
+    {
+        fill(sa.begin(), sa.end(), -1);
+        vector<int> bucket(startS);
+        for (int d : lms)
+        {
+            if (d != n)
+                sa[bucket[s[d]]++] = d;
+        }
+        bucket = startL;
+        sa[bucket[s[n - 1]]++] = n - 1;
+        for (int i = 0; i < n; ++i)
+        {
+            int v = sa[i];
+            if (v >= 1 && !isS[v - 1])
+                sa[bucket[s[v - 1]]++] = v - 1;
+        }
+        bucket = startL;
+        for (int i = n - 1; i >= 0; --i)
+        {
+            int v = sa[i];
+            if (v >= 1 && isS[v - 1])
+                sa[--bucket[s[v - 1] + 1]] = v - 1;
+        }
+    };
+
+    vector<int> lmsIndex(n + 1, -1), lms;
+    for (int i = 1; i < n; ++i)
+    {
+        if (!isS[i - 1] && isS[i])
+        {
+            lmsIndex[i] = lms.size();
+            lms.push_back(i);
+        }
+    }
+    int m = lms.size();
+    induce(lms);
+
+    if (m > 0)
+    {
+        vector<int> sortedLms;
+        sortedLms.reserve(m);
+        for (int v : sa)
+        {
+            if (lmsIndex[v] != -1)
+                sortedLms.push_back(v);
+        }
+
+        // Name the LMS substrings: equal substrings get the same name
+        vector<int> names(m);
+        int upperName = 0;
+        names[lmsIndex[sortedLms[0]]] = 0;
+        for (int i = 1; i < m; ++i)
+        {
+            int l = sortedLms[i - 1], r = sortedLms[i];
+            int endL = lmsIndex[l] + 1 < m ? lms[lmsIndex[l] + 1] : n;
+            int endR = lmsIndex[r] + 1 < m ? lms[lmsIndex[r] + 1] : n;
+            bool same = endL - l == endR - r;
+            if (same)
+            {
+                while (l < endL && s[l] == s[r])
+                {
+                    ++l;
+                    ++r;
+                }
+                if (l == n || s[l] != s[r])
+                    same = false;
+            }
+            if (!same)
+                upperName++;
+            names[lmsIndex[sortedLms[i]]] = upperName;
+        }
+
+        vector<int> namesOrder = suffixArrayIS(names, upperName);
+        for (int i = 0; i < m; ++i)
+        {
+            sortedLms[i] = lms[namesOrder[i]];
+        }
+        induce(sortedLms);
+    }
+    return sa;
+}
+
+// Persistent suffix array + LCP index of one transmission (the string returned by readFromFile), so a
+// capture is read and sorted once and every later query works on the mapped file without rebuilding.
+// File layout (native byte order): "TXINDEX1", the text length n as 8 bytes, the n text bytes padded to a
+// multiple of 4, then the suffix array and the LCP array as n 4-byte values each. lcp[r] is the longest
+// common prefix of the suffixes of rank r - 1 and r (lcp[0] = 0).
+// Positions in the results are 0-based, like KMP().
+class TransmissionIndex
+{
+public:
+    // Builds the index of text with SA-IS and Kasai's LCP algorithm and writes it to indexPath.
+    // Returns false if the text is too long for 32-bit positions or the file could not be written.
+    static bool build(const string &text, const string &indexPath)
+    {
+        size_t n = text.size();
+        if (n >= (size_t)INT_MAX)
+            return false;
+
+        vector<int> s(text.begin(), text.end());
+        for (int &c : s)
+        {
+            c = (unsigned char)c;
+        }
+        vector<int> suffixes = suffixArrayIS(s, 255);
+        s.clear();
+        s.shrink_to_fit();
+
+        // Kasai: going through the suffixes in text order, the LCP with the previous rank drops by at most 1
+        vector<int> rank(n), lcp(n, 0);
+        for (size_t r = 0; r < n; ++r)
+        {
+            rank[suffixes[r]] = r;
+        }
+        size_t h = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (rank[i] == 0)
+            {
+                h = 0;
+                continue;
+            }
+            size_t j = suffixes[rank[i] - 1];
+            while (i + h < n && j + h < n && text[i + h] == text[j + h])
+            {
+                h++;
+            }
+            lcp[rank[i]] = h;
+            if (h > 0)
+                h--;
+        }
+
+        ofstream file(indexPath, ios::binary);
+        if (!file.is_open())
+            return false;
+        uint64_t length = n;
+        file.write(magic, sizeof(magic));
+        file.write((const char *)&length, sizeof(length));
+        file.write(text.data(), n);
+        file.write("\0\0\0", paddedLength(n) - n);
+        file.write((const char *)suffixes.data(), n * sizeof(int));
+        file.write((const char *)lcp.data(), n * sizeof(int));
+        return (bool)file;
+    }
+
+    // Maps an index written by build(). Returns false if the file is missing or is not a valid index.
+    bool open(const string &indexPath)
+    {
+        close();
+        int descriptor = ::open(indexPath.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+        struct stat info;
+        size_t fileSize = fstat(descriptor, &info) == 0 ? info.st_size : 0;
+        if (fileSize >= headerSize)
+        {
+            void *address = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, descriptor, 0);
+            if (address != MAP_FAILED)
+            {
+                mapping = (const char *)address;
+                mappingSize = fileSize;
+            }
+        }
+        ::close(descriptor);
+        if (mapping == nullptr)
+            return false;
+
+        uint64_t length;
+        memcpy(&length, mapping + sizeof(magic), sizeof(length));
+        if (memcmp(mapping, magic, sizeof(magic)) != 0 || length >= (uint64_t)INT_MAX ||
+            headerSize + paddedLength(length) + 2 * length * sizeof(uint32_t) != mappingSize)
+        {
+            close();
+            return false;
+        }
+        n = length;
+        text = mapping + headerSize;
+        suffixes = (const uint32_t *)(text + paddedLength(n));
+        lcp = suffixes + n;
+        if (!hasValidArrays())
+        {
+            close();
+            return false;
+        }
+        madvise((void *)mapping, mappingSize, MADV_RANDOM); // binary searches jump around the file
+        return true;
+    }
+
+    void close()
+    {
+        if (mapping != nullptr)
+            munmap((void *)mapping, mappingSize);
+        mapping = text = nullptr;
+        suffixes = lcp = nullptr;
+        mappingSize = n = 0;
+    }
+
+    ~TransmissionIndex() { close(); }
+
+    size_t size() const { return n; }
+
+    // Ranks [first, last) of the suffixes that start with pattern, with two binary searches over the suffix
+    // array (O(m log n)). The empty pattern matches every suffix.
+    pair<size_t, size_t> range(const string &pattern) const
+    {
+        auto compare = [&](uint32_t position)
+        {
+            // <0, 0 or >0 as the first pattern.size() bytes of the suffix are before, equal or after pattern
+            size_t available = min(pattern.size(), n - position);
+            int result = memcmp(text + position, pattern.data(), available);
+            if (result == 0 && available < pattern.size())
+                result = -1; // the suffix is a proper prefix of pattern
+            return result;
+        };
+        size_t first = partition_point(suffixes, suffixes + n, [&](uint32_t p)
+                                       { return compare(p) < 0; }) -
+                       suffixes;
+        size_t last = partition_point(suffixes + first, suffixes + n, [&](uint32_t p)
+                                      { return compare(p) == 0; }) -
+                      suffixes;
+        return make_pair(first, last);
+    }
+
+    // The empty pattern is found once, at position 0, like KMP() and the other engines
+    long long count(const string &pattern) const
+    {
+        if (pattern.empty())
+            return 1;
+        pair<size_t, size_t> ranks = range(pattern);
+        return ranks.second - ranks.first;
+    }
+
+    // All the positions of pattern, sorted (the suffix array gives them in suffix order)
+    vector<long long> occurrences(const string &pattern) const
+    {
+        if (pattern.empty())
+            return {0};
+        pair<size_t, size_t> ranks = range(pattern);
+        vector<long long> positions(suffixes + ranks.first, suffixes + ranks.second);
+        sort(positions.begin(), positions.end());
+        return positions;
+    }
+
+    // Longest substring that appears at least twice: the largest LCP of two neighbouring suffixes.
+    // Returns (length, (first position, second position)), with the two positions in increasing order.
+    pair<long long, pair<long long, long long>> longestRepeat() const
+    {
+        size_t best = 0;
+        for (size_t r = 1; r < n; ++r)
+        {
+            if (lcp[r] > lcp[best])
+                best = r;
+        }
+        if (best == 0)
+            return make_pair(0, make_pair(-1, -1));
+        long long a = suffixes[best - 1], b = suffixes[best];
+        return make_pair((long long)lcp[best], make_pair(min(a, b), max(a, b)));
+    }
+
+    // Longest substring common to the indexed text and other, in O(|other| log n) binary search steps.
+    // For every start j in other, a binary search finds where other[j..] would go among the sorted suffixes;
+    // the longest match of other[j..] is with one of its two neighbours there. The search keeps the common
+    // prefix with both ends of the range, so the bytes they share with other[j..] are not compared again.
+    // Returns (length, (position in the indexed text, position in other)), or length 0 if nothing is common.
+    pair<long long, pair<long long, long long>> longestCommonSubstring(const string &other) const
+    {
+        long long bestLength = 0, bestText = -1, bestOther = -1;
+        for (size_t j = 0; j < other.size() && (long long)(other.size() - j) > bestLength; ++j)
+        {
+            const char *query = other.data() + j;
+            size_t queryLength = other.size() - j;
+            size_t low = 0, high = n;              // query goes between ranks low - 1 and high
+            size_t lowCommon = 0, highCommon = 0; // common prefix of query with those two suffixes
+            while (low < high)
+            {
+                size_t middle = low + (high - low) / 2;
+                size_t position = suffixes[middle];
+                size_t k = min(lowCommon, highCommon);
+                size_t limit = min(queryLength, n - position);
+                while (k < limit && text[position + k] == query[k])
+                {
+                    k++;
+                }
+                if (k == queryLength || (k < limit && (unsigned char)text[position + k] > (unsigned char)query[k]))
+                {
+                    high = middle; // suffix >= query
+                    highCommon = k;
+                }
+                else
+                {
+                    low = middle + 1;
+                    lowCommon = k;
+                }
+            }
+            if (low > 0 && (long long)lowCommon > bestLength)
+            {
+                bestLength = lowCommon;
+                bestText = suffixes[low - 1];
+                bestOther = j;
+            }
+            if (high < n && (long long)highCommon > bestLength)
+            {
+                bestLength = highCommon;
+                bestText = suffixes[high];
+                bestOther = j;
+            }
+        }
+        return make_pair(bestLength, make_pair(bestText, bestOther));
+    }
+
+private:
+    static constexpr char magic[8] = {'T', 'X', 'I', 'N', 'D', 'E', 'X', '1'};
+    static constexpr size_t headerSize = sizeof(magic) + sizeof(uint64_t);
+
+    static size_t paddedLength(size_t length) { return (length + 3) & ~(size_t)3; }
+
+    // The queries use the suffix array and LCP values as offsets into the text, so a damaged or foreign
+    // file must not get past open(): the suffix array has to be a permutation of 0..n-1, and every LCP has
+    // to fit in both suffixes it compares, with the two suffixes in order at the first byte they differ.
+    bool hasValidArrays() const
+    {
+        vector<bool> seen(n, false);
+        for (size_t r = 0; r < n; ++r)
+        {
+            if (suffixes[r] >= n || seen[suffixes[r]])
+                return false;
+            seen[suffixes[r]] = true;
+        }
+        if (n > 0 && lcp[0] != 0)
+            return false;
+        for (size_t r = 1; r < n; ++r)
+        {
+            size_t previous = suffixes[r - 1], current = suffixes[r];
+            if (lcp[r] > n - max(previous, current))
+                return false;
+            // The previous suffix is either a prefix of the current one or smaller at byte lcp[r]
+            if (previous + lcp[r] < n &&
+                (current + lcp[r] == n ||
+                 (unsigned char)text[previous + lcp[r]] >= (unsigned char)text[current + lcp[r]]))
+                return false;
+        }
+        return true;
+    }
+
+    const char *mapping = nullptr;
+    size_t mappingSize = 0;
+    size_t n = 0;
+    const char *text = nullptr;
+    const uint32_t *suffixes = nullptr;
+    const uint32_t *lcp = nullptr;
+};
+
+// Runs one --index query and prints its result (1-based positions, like the rest of the output).
+// Returns false if the index could not be opened or the query is unknown.
+bool runIndexQuery(const string &indexPath, const string &query, const string &argument)
+{
+    TransmissionIndex index;
+    if (!index.open(indexPath))
+    {
+        cout << RED << "Cannot open index " << indexPath << RESET << endl;
+        return false;
+    }
+    if (query == "search" || query == "count")
+    {
+        string pattern = readFromFile(argument);
+        if (query == "count")
+        {
+            cout << "Occurrences of " << argument << ": " << index.count(pattern) << endl;
+            return true;
+        }
+        vector<long long> positions = index.occurrences(pattern);
+        cout << argument << ": ";
+        if (positions.empty())
+            cout << RED << "false" << RESET;
+        else
+            cout << GREEN << "true " << RESET << GREEN << (positions.size() == 1 ? " at position " : " at positions ");
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            cout << (i > 0 ? ", " : "") << positions[i] + 1;
+        }
+        cout << RESET << endl;
+        return true;
+    }
+    if (query == "repeat")
+    {
+        pair<long long, pair<long long, long long>> repeat = index.longestRepeat();
+        cout << "Longest repeated substring: length " << repeat.first;
+        if (repeat.first > 0)
+            cout << ", starts at " << repeat.second.first + 1 << " and at " << repeat.second.second + 1;
+        cout << endl;
+        return true;
+    }
+    if (query == "lcs")
+    {
+        pair<long long, pair<long long, long long>> common = index.longestCommonSubstring(readFromFile(argument));
+        cout << "Longest common substring: length " << common.first;
+        if (common.first > 0)
+            cout << ", starts at " << common.second.first + 1 << ", ends at " << common.second.first + common.first
+                 << " (in " << argument << ": starts at " << common.second.second + 1 << ", ends at "
+                 << common.second.second + common.first << ")";
+        cout << endl;
+        return true;
+    }
+    cout << RED << "Unknown index query " << query << RESET << endl;
+    return false;
+}
+
+// Times KMP() against parallelKMP() (on every hardware thread) and simdFind() on 64 MB of random hex text
+// (like the transmissions) with signatures that are not in it, so all of them have to read the whole text.
+// Prints MB/s for each pattern length.
+void runSearchBenchmark()
+{
+    const string hexDigits = "0123456789ABCDEF";
+    mt19937 generator(42);
+    string text(64 << 20, ' ');
+    for (char &c : text)
+    {
+        c = hexDigits[generator() % 16];
+    }
+
+    int threadCount = max(1, (int)thread::hardware_concurrency());
+    cout << "Parallel KMP: " << threadCount << " threads" << endl;
+    cout << "SIMD engine: " <<
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        (cpuHasAvx2 ? "AVX2 (32 positions per step)" : "SSE2 (16 positions per step)")
+#else
+        "scalar"
+#endif
+         << endl;
+    for (int length : {2, 4, 8, 16, 32})
+    {
+        string pattern;
+        for (int i = 0; i < length; ++i)
+        {
+            pattern += hexDigits[generator() % 16];
+        }
+        pattern.back() = 'Z'; // never in the text
+
+        auto start = chrono::steady_clock::now();
+        int kmpResult = KMP(text, pattern);
+        double kmpSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        long long parallelResult = parallelKMP(text, pattern, threadCount);
+        double parallelSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        long long simdResult = simdFind(text, pattern);
+        double simdSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        double megabytes = text.size() / 1048576.0;
+        bool same = kmpResult == parallelResult && kmpResult == simdResult;
+        cout << "Pattern length " << length << ": KMP " << (int)(megabytes / kmpSeconds) << " MB/s, parallel KMP "
+             << (int)(megabytes / parallelSeconds) << " MB/s, SIMD " << (int)(megabytes / simdSeconds) << " MB/s"
+             << (same ? "" : "  (results differ!)") << endl;
+    }
+}
+
+// Usage: ./TransmissionAnalysis [--stream | --threads T | --simd] [mcode files...]
+//        (default mcodes: mcode1.txt mcode2.txt mcode3.txt; compile with -pthread)
+// --stream searches the transmissions straight from the files with StreamingKMP, in constant memory, and only
+// does the malicious code check (the palindrome and common substring parts need the whole text in memory).
+// --threads T searches every (transmission, mcode) pair with parallelSearch on T threads.
+// --simd searches every pair with the SIMD prefilter engine (simdSearch).
+// ./TransmissionAnalysis --bench compares KMP(), parallelKMP() and the SIMD engine.
+// ./TransmissionAnalysis --build-index <transmission file> <index file> builds the suffix array + LCP index
+// of a transmission once; then ./TransmissionAnalysis --index <index file> <query> answers from the mapped
+// index without reading the transmission again, where <query> is one of:
+//   search <pattern file>   every position of the pattern
+//   count <pattern file>    number of occurrences of the pattern
+//   repeat                  longest repeated substring
+//   lcs <file>              longest common substring with the transmission in file
+int main(int argc, char *argv[])
 {
     string transmissionFiles[] = {"transmission1.txt", "transmission2.txt"};
-    string mcodeFiles[] = {"mcode1.txt", "mcode2.txt", "mcode3.txt"};
+    vector<string> mcodeFiles;
+    bool streaming = false;
+    int threadCount = 0; // 0 = Aho-Corasick on one thread
+    bool useSimd = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        string argument = argv[i];
+        if (argument == "--stream")
+        {
+            streaming = true;
+        }
+        else if (argument == "--simd")
+        {
+            useSimd = true;
+        }
+        else if (argument == "--bench")
+        {
+            runSearchBenchmark();
+            return 0;
+        }
+        else if (argument == "--build-index" && i + 2 < argc)
+        {
+            string transmission = readFromFile(argv[i + 1]);
+            if (!TransmissionIndex::build(transmission, argv[i + 2]))
+            {
+                cout << RED << "Cannot build index " << argv[i + 2] << RESET << endl;
+                return 1;
+            }
+            cout << "Indexed " << transmission.size() << " bytes of " << argv[i + 1] << " into " << argv[i + 2] << endl;
+            return 0;
+        }
+        else if (argument == "--index" && i + 2 < argc)
+        {
+            string query = argv[i + 2];
+            return runIndexQuery(argv[i + 1], query, i + 3 < argc ? argv[i + 3] : "") ? 0 : 1;
+        }
+        else if (argument == "--threads" && i + 1 < argc)
+        {
+            threadCount = max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            mcodeFiles.push_back(argument);
+        }
+    }
+    if (mcodeFiles.empty())
+    {
+        mcodeFiles = {"mcode1.txt", "mcode2.txt", "mcode3.txt"};
+    }
+
+    vector<string> mcodes(mcodeFiles.size());
+    for (size_t i = 0; i < mcodeFiles.size(); ++i)
+    {
+        mcodes[i] = readFromFile(mcodeFiles[i]);
+    }
+
+    if (streaming)
+    {
+        cout << MAGENTA << "Checking for malicious codes in transmissions:" << RESET << endl;
+        for (int i = 0; i < 2; ++i)
+        {
+            for (size_t j = 0; j < mcodes.size(); ++j)
+            {
+                StreamingKMP matcher(mcodes[j]);
+                OccurrencePrinter printer(i + 1, j + 1);
+                streamSearch(transmissionFiles[i], matcher, [&](long long position)
+                             { printer.add(position); });
+                printer.finish();
+            }
+        }
+        return 0;
+    }
 
     // Read content from all files
     string transmissions[2];
-    string mcodes[3];
     for (int i = 0; i < 2; ++i)
     {
         transmissions[i] = readFromFile(transmissionFiles[i]);
     }
-    for (int i = 0; i < 3; ++i)
-    {
-        mcodes[i] = readFromFile(mcodeFiles[i]);
-    }
 
     cout << MAGENTA << "Checking for malicious codes in transmissions:" << RESET << endl;
     // Check for malicious codes in transmissions
-    for (int i = 0; i < 2; ++i)
+    if (threadCount > 0)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            for (size_t j = 0; j < mcodes.size(); ++j)
+            {
+                OccurrencePrinter printer(i + 1, j + 1);
+                for (long long position : parallelSearch(transmissions[i], mcodes[j], threadCount, false))
+                {
+                    printer.add(position);
+                }
+                printer.finish();
+            }
+        }
+    }
+    else if (useSimd)
     {
-        for (int j = 0; j < 3; ++j)
+        for (int i = 0; i < 2; ++i)
         {
-            int foundAt = KMP(transmissions[i], mcodes[j]);
-            cout << "Transmission " << (i + 1) << " - mcode " << (j + 1) << ": ";
-            cout << (foundAt != -1 ? GREEN + "true " + RESET : RED + "false" + RESET);
-            if (foundAt != -1)
+            for (size_t j = 0; j < mcodes.size(); ++j)
             {
-                cout << GREEN << " at position " << foundAt + 1 << RESET; // Output is 1-based index
+                OccurrencePrinter printer(i + 1, j + 1);
+                simdSearch(transmissions[i], mcodes[j], [&](long long position)
+                           { printer.add(position); return true; });
+                printer.finish();
+            }
+        }
+    }
+    else
+    {
+        // One automaton for all the mcodes, then one pass per transmission
+        AhoCorasick automaton(mcodes);
+        for (int i = 0; i < 2; ++i)
+        {
+            vector<vector<int>> occurrences(mcodes.size());
+            automaton.scan(transmissions[i], [&](int mcode, int position)
+                           { occurrences[mcode].push_back(position); });
+
+            for (size_t j = 0; j < mcodes.size(); ++j)
+            {
+                OccurrencePrinter printer(i + 1, j + 1);
+                for (int position : occurrences[j]) // increasing, the first one is what KMP() returns
+                {
+                    printer.add(position);
+                }
+                printer.finish();
             }
-            cout << endl;
         }
     }
 
@@ -195,7 +1517,7 @@ int main()
 
     cout << MAGENTA << "Longest common substring between the two transmissions:" << RESET << endl;
     // Find the longest common substring between the two transmissions
-    pair<int, int> commonResult = longestCommonSubstring(transmissions[0], transmissions[1]);
+    pair<int, int> commonResult = longestCommonSubstringSAM(transmissions[0], transmissions[1]);
     cout << "Starts at " << commonResult.first << ", ends at " << commonResult.second << endl;
 
     return 0;
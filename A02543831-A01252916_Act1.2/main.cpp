@@ -2,12 +2,43 @@
 // The problem is as follows: given a set of coins, and a target value, find the minimum number of coins needed to reach the target value.
 
 // To run this code you can use the following command:
-// g++ -o main main.cpp
+// g++ -std=c++17 -O2 -o main main.cpp
 // And then to read the input from our test file you can use the following command:
 // ./main < in.txt
 
+// Batch mode (many queries against the same coins):
+//   ./main --batch [maxAmount] [--table <file>] < queries.txt
+// where queries.txt has N, the N coins, and then one "P Q" line per query.
+// With --table the precomputed table is loaded from <file> (memory-mapped) or built and saved there.
+// If the coins are canonical (greedy is always optimal) the batch skips the DP and uses greedy.
+//   ./main --huge < queries.txt
+// answers queries with 64-bit amounts (billions and more) without a table as long as the amount, using
+// shortest paths over the remainders modulo the biggest coin.
+//   ./main --vectorized < in.txt
+// computes the DP result with the coin-major SIMD kernel instead of the original loops (same output).
+//   ./main --drawer < drawer.txt
+// cash drawer with a limited number of each coin: N, the N coins, the N stock counts, then "P Q" lines;
+// every transaction removes the coins it gives from the drawer. A transaction needs about 4 * N * (Q - P)
+// bytes of memory (the table used to rebuild the breakdown).
+//   ./main --check < in.txt
+// only tells whether the coins in in.txt are canonical (and the smallest amount where greedy fails).
+
 #include <iostream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <queue>
+#include <tuple>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
@@ -112,6 +143,199 @@ vector<int> DymamicProgrammingApproach(int change, vector<int> &CurrencyUnits)
     return result;
 }
 
+// ---------------------------------------------------------------------------
+// Vectorized (coin-major) DP
+// ---------------------------------------------------------------------------
+// DymamicProgrammingApproach goes amount by amount and tries every coin, with an `if` per (amount, coin) pair
+// that the CPU can't predict and the compiler can't vectorize. We can swap the loops: for each coin c, sweep
+// all amounts with dp[i] = min(dp[i], dp[i - c] + 1). That gives the same dp values (it is the usual unbounded
+// knapsack order), and when c is at least the vector width, the dp[i - c] values a vector needs are already
+// final, so a whole vector of amounts is updated with one add and one min and no branches.
+//
+// The counts are stored in 16 bits when they can't get bigger than about 32700 (change / smallest coin), which puts
+// twice as many amounts in each vector; otherwise 32 bits.
+//
+// coinsUsed has to match DymamicProgrammingApproach exactly. There the coin kept for amount i is the FIRST coin
+// j (in CurrencyUnits order) with dp[i - c_j] + 1 == dp[i], since only a strictly better coin replaces it. So
+// after the dp is final we go over the coins from last to first and overwrite coinsUsed with a vector blend
+// wherever that equality holds: the first coin is written last and wins.
+
+// Amounts are processed in blocks that fit in the L1/L2 cache: every coin sweeps the block, then the block's
+// coinsUsed is filled while it is still in cache. This is still correct because values of earlier blocks are
+// already final, and inside the block coin j sees every amount below it updated with coins 0..j.
+const int coinDPBlockSize = 4096;
+
+template <typename Count, int Lanes>
+__attribute__((always_inline)) inline void coinMajorKernel(Count *dp, Count *used, int change, const vector<int> &coins, Count infinity)
+{
+    typedef Count Vector __attribute__((vector_size(Lanes * sizeof(Count))));
+    const int n = coins.size();
+
+    for (int blockStart = 1; blockStart <= change; blockStart += coinDPBlockSize)
+    {
+        int blockEnd = min(change, blockStart + coinDPBlockSize - 1);
+
+        for (int j = 0; j < n; j++)
+        {
+            int c = coins[j], i = max(c, blockStart);
+            if (c >= Lanes)
+            {
+                for (; i + Lanes - 1 <= blockEnd; i += Lanes)
+                {
+                    Vector current, previous;
+                    memcpy(&current, dp + i, sizeof(Vector));
+                    memcpy(&previous, dp + i - c, sizeof(Vector));
+                    Vector candidate = previous + 1; // infinity + 1 still fits, and never wins the min
+                    current = candidate < current ? candidate : current;
+                    memcpy(dp + i, &current, sizeof(Vector));
+                }
+            }
+            else
+            {
+                // A small coin reads values from its own vector, so we do a prefix "min-plus" scan instead:
+                // compare with the values c, 2c, 4c, ... positions back (+1, +2, +4, ... coins), storing after
+                // every step so the next shifted load sees it. Values before the vector are already up to date.
+                for (; i < 2 * Lanes && i <= blockEnd; i++)
+                {
+                    Count candidate = dp[i - c] + 1;
+                    if (candidate < dp[i])
+                        dp[i] = candidate;
+                }
+                for (; i + Lanes - 1 <= blockEnd; i += Lanes)
+                {
+                    Vector current;
+                    memcpy(&current, dp + i, sizeof(Vector));
+                    for (int shift = c, added = 1; shift < 2 * Lanes; shift *= 2, added *= 2)
+                    {
+                        Vector previous;
+                        memcpy(&previous, dp + i - shift, sizeof(Vector));
+                        Vector candidate = previous + (Count)added;
+                        current = candidate < current ? candidate : current;
+                        memcpy(dp + i, &current, sizeof(Vector));
+                    }
+                }
+            }
+            for (; i <= blockEnd; i++) // the tail that doesn't fill a whole vector
+            {
+                Count candidate = dp[i - c] + 1;
+                if (candidate < dp[i])
+                    dp[i] = candidate;
+            }
+        }
+
+        // The block is final now: blend in the first coin that reaches each amount (last coin first)
+        for (int j = n - 1; j >= 0; j--)
+        {
+            int c = coins[j], i = max(c, blockStart);
+            Vector coinIndex = Vector{} + (Count)j;
+            for (; i + Lanes - 1 <= blockEnd; i += Lanes)
+            {
+                Vector current, previous, usedCoins;
+                memcpy(&current, dp + i, sizeof(Vector));
+                memcpy(&previous, dp + i - c, sizeof(Vector));
+                memcpy(&usedCoins, used + i, sizeof(Vector));
+                usedCoins = ((previous != infinity) & (previous + 1 == current)) ? coinIndex : usedCoins;
+                memcpy(used + i, &usedCoins, sizeof(Vector));
+            }
+            for (; i <= blockEnd; i++)
+            {
+                if (dp[i - c] != infinity && dp[i - c] + 1 == dp[i])
+                    used[i] = j;
+            }
+        }
+    }
+}
+
+template <typename Count, int Lanes>
+void coinMajorPortable(Count *dp, Count *used, int change, const vector<int> &coins, Count infinity)
+{
+    coinMajorKernel<Count, Lanes>(dp, used, change, coins, infinity);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COIN_CHANGE_HAS_AVX2_PATH 1
+
+template <typename Count, int Lanes>
+__attribute__((target("avx2"))) void coinMajorAvx2(Count *dp, Count *used, int change, const vector<int> &coins, Count infinity)
+{
+    coinMajorKernel<Count, Lanes>(dp, used, change, coins, infinity);
+}
+#endif
+
+// Fills dp (minimum coins, INT_MAX = impossible) and coinsUsed (-1 = none) for amounts 0..change,
+// exactly like the loops of DymamicProgrammingApproach. Picks 16 or 32-bit counts and AVX2 or the
+// default 16-byte vectors at runtime.
+void coinMajorDP(int change, const vector<int> &CurrencyUnits, vector<int> &dp, vector<int> &coinsUsed)
+{
+    int smallestCoin = CurrencyUnits.empty() ? 1 : *min_element(CurrencyUnits.begin(), CurrencyUnits.end());
+    bool narrow = change / max(smallestCoin, 1) < 32767 - 64;
+#ifdef COIN_CHANGE_HAS_AVX2_PATH
+    bool avx2 = __builtin_cpu_supports("avx2");
+#else
+    bool avx2 = false;
+#endif
+
+    dp.assign(change + 1, INT_MAX);
+    coinsUsed.assign(change + 1, -1);
+
+    if (narrow)
+    {
+        const int16_t infinity = 32767 - 64; // room for "+ added" without overflowing
+        vector<int16_t> dp16(change + 1, infinity), used16(change + 1, -1);
+        dp16[0] = 0;
+#ifdef COIN_CHANGE_HAS_AVX2_PATH
+        if (avx2)
+            coinMajorAvx2<int16_t, 16>(dp16.data(), used16.data(), change, CurrencyUnits, infinity);
+        else
+#endif
+            coinMajorPortable<int16_t, 8>(dp16.data(), used16.data(), change, CurrencyUnits, infinity);
+        for (int i = 0; i <= change; i++)
+        {
+            dp[i] = dp16[i] == infinity ? INT_MAX : dp16[i];
+            coinsUsed[i] = used16[i];
+        }
+    }
+    else
+    {
+        // 32 bits: work directly in the output arrays and turn our infinity into INT_MAX at the end
+        const int infinity = INT_MAX - 64;
+        fill(dp.begin(), dp.end(), infinity);
+        dp[0] = 0;
+#ifdef COIN_CHANGE_HAS_AVX2_PATH
+        if (avx2)
+            coinMajorAvx2<int, 8>(dp.data(), coinsUsed.data(), change, CurrencyUnits, infinity);
+        else
+#endif
+            coinMajorPortable<int, 4>(dp.data(), coinsUsed.data(), change, CurrencyUnits, infinity);
+        for (int &count : dp)
+            count = count == infinity ? INT_MAX : count;
+    }
+    (void)avx2;
+}
+
+// Same answer (and same message) as DymamicProgrammingApproach, computed with the vectorized kernel
+vector<int> VectorizedDPApproach(int change, vector<int> &CurrencyUnits)
+{
+    vector<int> dp, coinsUsed;
+    coinMajorDP(change, CurrencyUnits, dp, coinsUsed);
+
+    if (dp[change] == INT_MAX)
+    {
+        cout << "It is not possible to make change for this amount\n";
+        return vector<int>();
+    }
+
+    vector<int> result(CurrencyUnits.size(), 0);
+    int remainingChange = change;
+    while (remainingChange > 0)
+    {
+        int coinIndex = coinsUsed[remainingChange];
+        result[coinIndex]++;
+        remainingChange -= CurrencyUnits[coinIndex];
+    }
+    return result;
+}
+
 void printCoins(vector<int> &coins, vector<int> &CurrencyUnits, int change)
 {
 
@@ -125,8 +349,657 @@ void printCoins(vector<int> &coins, vector<int> &CurrencyUnits, int change)
     }
 }
 
-int main()
+// Same output for 64-bit amounts and counts
+void printCoins(vector<long long> &coins, vector<int> &CurrencyUnits, long long change)
+{
+    cout << "Total change to provide:\033[1;31m " << change << " \033[0munits\n";
+    for (size_t i = 0; i < coins.size(); ++i)
+    {
+        if (coins[i] > 0)
+        {
+            cout << "CurrencyUnits: \033[1;32m" << CurrencyUnits[i] << "\033[0m - Number of coins: \033[1;33m" << coins[i] << "\033[0m" << endl;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Canonical coin systems (when is greedy already optimal?)
+// ---------------------------------------------------------------------------
+// For most real currencies (1, 2, 5, 10, 20, 50, ...) the greedy answer is always the optimal one; such coin
+// systems are called "canonical". {1, 3, 4} is not: greedy pays 6 as 4 + 1 + 1 but 3 + 3 is better.
+// We can find out once per set of coins, in O(n^3), with Pearson's algorithm: if the system is not canonical,
+// the smallest counterexample is built from the greedy solution of (c[i-1] - 1) for some coin i, keeping its
+// first j - 1 counts, adding one coin j and dropping the rest. So we only need to try those n^2 candidates.
+// (Kozen and Zaks also showed that a counterexample, if any, is smaller than the sum of the two biggest coins.)
+// When the coins are canonical every query can use the O(n) greedy below and skip the DP completely.
+
+// Greedy using division instead of repeated subtraction: O(n). `coins` must be sorted from biggest to smallest.
+// Returns an empty vector when greedy can't pay the exact amount.
+vector<int> fastGreedy(int change, const vector<int> &coins)
+{
+    vector<int> coinsUsed(coins.size(), 0);
+    for (size_t i = 0; i < coins.size(); i++)
+    {
+        coinsUsed[i] = change / coins[i];
+        change %= coins[i];
+    }
+    return change == 0 ? coinsUsed : vector<int>();
+}
+
+// Returns the smallest amount where greedy is not optimal, or -1 if the system is canonical.
+// Systems without a coin of 1 are reported as non-canonical (returns 0) because there greedy can get
+// stuck on amounts that can be paid, so the DP is always needed.
+long long findGreedyCounterexample(vector<int> coins)
+{
+    sort(coins.begin(), coins.end(), greater<int>());
+    coins.erase(unique(coins.begin(), coins.end()), coins.end());
+    int n = coins.size();
+    if (n == 0 || coins[n - 1] != 1)
+        return 0;
+
+    long long smallest = -1;
+    for (int i = 1; i < n; i++)
+    {
+        vector<int> greedyOfPrevious = fastGreedy(coins[i - 1] - 1, coins);
+        for (int j = i; j < n; j++)
+        {
+            // Candidate: greedy counts of coins 0..j-1, one more coin j, nothing smaller
+            long long amount = 0, candidateCoins = 0;
+            for (int k = 0; k < j; k++)
+            {
+                amount += (long long)greedyOfPrevious[k] * coins[k];
+                candidateCoins += greedyOfPrevious[k];
+            }
+            amount += (long long)(greedyOfPrevious[j] + 1) * coins[j];
+            candidateCoins += greedyOfPrevious[j] + 1;
+
+            // How many coins greedy uses for that amount
+            long long greedyCoins = 0, remaining = amount;
+            for (int k = 0; k < n; k++)
+            {
+                greedyCoins += remaining / coins[k];
+                remaining %= coins[k];
+            }
+
+            if (candidateCoins < greedyCoins && (smallest == -1 || amount < smallest))
+                smallest = amount;
+        }
+    }
+    return smallest;
+}
+
+bool isCanonical(const vector<int> &coins)
+{
+    return findGreedyCounterexample(coins) == -1;
+}
+
+// ---------------------------------------------------------------------------
+// Precomputed coin change table (for many queries with the same coins)
+// ---------------------------------------------------------------------------
+// DymamicProgrammingApproach builds the dp and coinsUsed arrays again for every amount. But dp[i] only depends
+// on the coins, not on the amount we were asked for, so a table built once up to the biggest amount answers
+// every smaller amount too. This class builds that table once (same arrays as DymamicProgrammingApproach, so
+// the answers are exactly the same) and then each query just follows the coinsUsed chain: O(coins used).
+//
+// The table can be saved to a file and loaded back with mmap, so the next process starts with the table ready
+// instead of rebuilding it. File layout (all 32-bit ints):
+//   "COINTBL1" | coin count | max amount | coins[] | minimum coins[0..max] | last coin used[0..max]
+
+class CoinChangeTable
+{
+public:
+    // Builds the table for amounts 0..maxAmount. Time O(n * maxAmount), space O(maxAmount).
+    // Uses the vectorized coin-major kernel, which gives exactly the same arrays as the original loops.
+    CoinChangeTable(const vector<int> &CurrencyUnits, int maxAmount) : coins(CurrencyUnits), maxAmount(maxAmount)
+    {
+        coinMajorDP(maxAmount, coins, ownedCounts, ownedLastCoin);
+        counts = ownedCounts.data();
+        lastCoin = ownedLastCoin.data();
+    }
+
+    // Maps a table written by `save`. Check `isValid()` afterwards: it is false when the file is missing,
+    // truncated, or its content is not a consistent table.
+    explicit CoinChangeTable(const string &path)
+    {
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return;
+        struct stat information;
+        if (fstat(descriptor, &information) == 0 && information.st_size >= 16)
+        {
+            mappingSize = (size_t)information.st_size;
+            void *address = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+            if (address != MAP_FAILED)
+                mapping = address;
+        }
+        close(descriptor);
+        if (!mapping)
+            return;
+
+        const char *bytes = (const char *)mapping;
+        const int32_t *header = (const int32_t *)(bytes + 8);
+        int coinCount = header[0];
+        maxAmount = header[1];
+        size_t expectedSize = 16 + sizeof(int32_t) * ((size_t)coinCount + 2 * ((size_t)maxAmount + 1));
+        if (memcmp(bytes, "COINTBL1", 8) != 0 || coinCount < 0 || maxAmount < 0 || expectedSize != mappingSize)
+        {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            return;
+        }
+
+        const int32_t *data = header + 2;
+        coins.assign(data, data + coinCount);
+        counts = data + coinCount;
+        lastCoin = counts + maxAmount + 1;
+
+        // The size matches the header, but the content can still be damaged: check every link of the
+        // coinsUsed chains once (O(maxAmount)), so `breakdown` never reads outside the table or loops forever
+        if (!hasValidChains())
+        {
+            munmap(mapping, mappingSize);
+            mapping = nullptr;
+            counts = lastCoin = nullptr;
+            coins.clear();
+        }
+    }
+
+    ~CoinChangeTable()
+    {
+        if (mapping)
+            munmap(mapping, mappingSize);
+    }
+
+    CoinChangeTable(const CoinChangeTable &) = delete;
+    CoinChangeTable &operator=(const CoinChangeTable &) = delete;
+
+    bool isValid() const { return counts != nullptr; }
+    int getMaxAmount() const { return maxAmount; }
+    const vector<int> &getCoins() const { return coins; }
+
+    // Writes the table so another process can map it with the constructor above
+    bool save(const string &path) const
+    {
+        FILE *file = fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        int32_t header[2] = {(int32_t)coins.size(), maxAmount};
+        bool ok = fwrite("COINTBL1", 1, 8, file) == 8 &&
+                  fwrite(header, sizeof(int32_t), 2, file) == 2 &&
+                  fwrite(coins.data(), sizeof(int32_t), coins.size(), file) == coins.size() &&
+                  fwrite(counts, sizeof(int32_t), maxAmount + 1, file) == (size_t)maxAmount + 1 &&
+                  fwrite(lastCoin, sizeof(int32_t), maxAmount + 1, file) == (size_t)maxAmount + 1;
+        return fclose(file) == 0 && ok;
+    }
+
+    // Minimum number of coins for `amount`, or -1 when it can't be paid (or it is bigger than the table)
+    int minimumCoins(int amount) const
+    {
+        if (amount < 0 || amount > maxAmount || counts[amount] == INT_MAX)
+            return -1;
+        return counts[amount];
+    }
+
+    // How many coins of each denomination, same format as DymamicProgrammingApproach (empty if impossible)
+    vector<int> breakdown(int amount) const
+    {
+        if (minimumCoins(amount) < 0)
+            return vector<int>();
+
+        vector<int> result(coins.size(), 0);
+        while (amount > 0)
+        {
+            int coinIndex = lastCoin[amount];
+            result[coinIndex]++;
+            amount -= coins[coinIndex];
+        }
+        return result;
+    }
+
+    // Answers a whole batch of amounts
+    vector<vector<int>> answer(const vector<int> &amounts) const
+    {
+        vector<vector<int>> results;
+        results.reserve(amounts.size());
+        for (int amount : amounts)
+            results.push_back(breakdown(amount));
+        return results;
+    }
+
+private:
+    // Every payable amount must point to a real coin no bigger than itself, leading to an amount that uses
+    // exactly one coin less, and the amount 0 must use no coins
+    bool hasValidChains() const
+    {
+        for (int coin : coins)
+            if (coin <= 0)
+                return false;
+        if (counts[0] != 0)
+            return false;
+        for (int amount = 1; amount <= maxAmount; amount++)
+        {
+            if (counts[amount] == INT_MAX)
+                continue;
+            int coinIndex = lastCoin[amount];
+            if (coinIndex < 0 || coinIndex >= (int)coins.size() || coins[coinIndex] > amount ||
+                counts[amount] <= 0 || counts[amount - coins[coinIndex]] != counts[amount] - 1)
+                return false;
+        }
+        return true;
+    }
+
+    vector<int> coins;
+    int maxAmount = 0;
+    const int32_t *counts = nullptr;   // points into the owned vectors or into the mapped file
+    const int32_t *lastCoin = nullptr; //
+    vector<int> ownedCounts, ownedLastCoin;
+    void *mapping = nullptr;
+    size_t mappingSize = 0;
+};
+
+// Prints the answers of a batch the same way as the single query
+void printBatchResults(const vector<vector<int>> &results, const vector<int> &amounts, vector<int> &CurrencyUnits)
+{
+    for (size_t i = 0; i < amounts.size(); i++)
+    {
+        vector<int> result = results[i];
+        if (result.empty())
+            cout << "It is not possible to make change for this amount\n";
+        printCoins(result, CurrencyUnits, amounts[i]);
+    }
+}
+
+// Batch mode: after the coins, the input has any number of "P Q" lines (price, amount paid).
+// If the coins are canonical every query is answered with `fastGreedy` and no table is built at all.
+// Otherwise the table is loaded from `tablePath` when it exists and matches the coins, otherwise it is built up to
+// `maxAmount` (or the biggest change in the batch) and saved to `tablePath` for the next run.
+// A query that pays less than the price (negative change) can't be answered by either path, so it is
+// rejected here once; it gets the "not possible" answer.
+int runBatch(vector<int> &CurrencyUnits, int maxAmount, const string &tablePath)
+{
+    vector<int> amounts;
+    vector<bool> negative;
+    int P, Q;
+    while (cin >> P >> Q)
+    {
+        amounts.push_back(Q - P);
+        negative.push_back(Q - P < 0);
+        maxAmount = max(maxAmount, Q - P);
+    }
+
+    vector<vector<int>> results(amounts.size());
+    if (isCanonical(CurrencyUnits))
+    {
+        cerr << "Canonical coin system: using greedy for every query" << endl;
+        for (size_t i = 0; i < amounts.size(); i++)
+            if (!negative[i])
+                results[i] = fastGreedy(amounts[i], CurrencyUnits);
+        printBatchResults(results, amounts, CurrencyUnits);
+        return 0;
+    }
+
+    // A saved table is only used when it was built for the same coins and is big enough
+    CoinChangeTable savedTable(tablePath);
+    bool useSaved = savedTable.isValid() && savedTable.getCoins() == CurrencyUnits && savedTable.getMaxAmount() >= maxAmount;
+    CoinChangeTable builtTable(CurrencyUnits, useSaved ? 0 : maxAmount);
+    if (!useSaved && !tablePath.empty() && !builtTable.save(tablePath))
+        cerr << "Warning: could not save the table to " << tablePath << endl;
+    const CoinChangeTable &table = useSaved ? savedTable : builtTable;
+
+    for (size_t i = 0; i < amounts.size(); i++)
+        if (!negative[i])
+            results[i] = table.breakdown(amounts[i]);
+    printBatchResults(results, amounts, CurrencyUnits);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Huge amounts: shortest paths over residues
+// ---------------------------------------------------------------------------
+// The dense DP needs an array as long as the amount, so amounts in the billions don't fit in memory (and the
+// int counts overflow). But with L = the biggest coin, any payment is "some other coins" plus k coins of L.
+// Only the remainder modulo L of the other coins matters, so we work on a graph of L nodes (the residues
+// 0..L-1) where using a coin c moves from residue r to (r + c) mod L.
+//
+//   - Optimal count: paying A with the other coins S (sum s) plus (A - s) / L coins of L costs
+//     |S| + (A - s) / L = (L*|S| - s + A) / L coins, so we minimise L*|S| - s. Every coin c adds L - c >= 0,
+//     which is a normal non-negative edge weight, so Dijkstra finds the best S for every residue.
+//   - Feasibility: A can be paid iff the smallest sum of other coins with A's residue is <= A (the rest is
+//     paid with coins of L). That is a second Dijkstra with edge weight c.
+//
+// After that setup (O(L * n log L) time, O(L * n) memory for the per-residue coin counts) a query is O(1) to
+// know if it can be paid and O(n) to write the breakdown, for any 64-bit amount. The only exception is a
+// small amount that can be paid but is below the sum of the best S of its residue. Those amounts (all below
+// T = the biggest such sum, always < L * L) are answered from a dense DP table. It is built on demand, only up
+// to the biggest such amount queried so far, so it costs O(n * A) time and O(A) memory for a query A < T and
+// nothing when no query needs it. For real currencies T is 0 or tiny (the best S is also the smallest one),
+// but adversarial systems like {L, L - 1, 2} make it close to L * L, too big to build in advance.
+
+class ResidueCoinChange
+{
+public:
+    // `coins` must be sorted from biggest to smallest (like main does); coins[0] is the modulus
+    explicit ResidueCoinChange(const vector<int> &coins) : coins(coins), modulus(coins.empty() ? 1 : coins[0])
+    {
+        int n = coins.size();
+        const long long infinity = LLONG_MAX;
+
+        // Dijkstra 1: smallest sum of non-L coins for every residue (feasibility)
+        minimumSum.assign(modulus, infinity);
+        minimumSum[0] = 0;
+        {
+            priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> queue;
+            queue.push({0, 0});
+            while (!queue.empty())
+            {
+                auto [sum, residue] = queue.top();
+                queue.pop();
+                if (sum != minimumSum[residue])
+                    continue;
+                for (int j = 1; j < n; j++)
+                {
+                    int next = (residue + coins[j]) % modulus;
+                    if (sum + coins[j] < minimumSum[next])
+                    {
+                        minimumSum[next] = sum + coins[j];
+                        queue.push({minimumSum[next], next});
+                    }
+                }
+            }
+        }
+
+        // Dijkstra 2: cheapest (L*|S| - s) for every residue, ties broken by the smaller sum s so that more
+        // amounts can use the answer directly. We remember the tree to rebuild the coin counts.
+        cost.assign(modulus, infinity);
+        bestSum.assign(modulus, infinity);
+        vector<int> parent(modulus, -1), parentCoin(modulus, -1), order;
+        order.reserve(modulus);
+        cost[0] = 0;
+        bestSum[0] = 0;
+        {
+            typedef tuple<long long, long long, int> Entry; // cost, sum, residue
+            priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+            vector<char> done(modulus, 0);
+            queue.push({0, 0, 0});
+            while (!queue.empty())
+            {
+                auto [pathCost, sum, residue] = queue.top();
+                queue.pop();
+                if (done[residue])
+                    continue;
+                done[residue] = 1;
+                order.push_back(residue);
+                for (int j = 1; j < n; j++)
+                {
+                    int next = (residue + coins[j]) % modulus;
+                    long long nextCost = pathCost + (modulus - coins[j]);
+                    long long nextSum = sum + coins[j];
+                    if (!done[next] && make_pair(nextCost, nextSum) < make_pair(cost[next], bestSum[next]))
+                    {
+                        cost[next] = nextCost;
+                        bestSum[next] = nextSum;
+                        parent[next] = residue;
+                        parentCoin[next] = j;
+                        queue.push({nextCost, nextSum, next});
+                    }
+                }
+            }
+        }
+
+        // Coin counts of the best S of every residue, filled in Dijkstra order so the parent is always ready
+        counts.assign((size_t)modulus * n, 0);
+        for (int residue : order)
+        {
+            if (residue == 0)
+                continue;
+            copy(&counts[(size_t)parent[residue] * n], &counts[(size_t)parent[residue] * n] + n, &counts[(size_t)residue * n]);
+            counts[(size_t)residue * n + parentCoin[residue]]++;
+        }
+
+        // Amounts in [minimumSum[r], bestSum[r]) need the dense table, which is only built when one is asked
+        denseLimit = 0;
+        for (int residue = 0; residue < modulus; residue++)
+            if (bestSum[residue] != infinity && bestSum[residue] > minimumSum[residue])
+                denseLimit = max(denseLimit, bestSum[residue] - 1);
+    }
+
+    // O(1): can `amount` be paid exactly?
+    bool canPay(long long amount) const
+    {
+        if (amount < 0 || coins.empty())
+            return false;
+        return minimumSum[amount % modulus] <= amount;
+    }
+
+    // O(n): coins of each denomination for an optimal payment (empty if it can't be paid). The few small
+    // amounts below the best sum of their residue first grow the dense table up to them (see above).
+    vector<long long> breakdown(long long amount)
+    {
+        if (!canPay(amount))
+            return vector<long long>();
+
+        int residue = amount % modulus;
+        if (bestSum[residue] > amount)
+            return denseBreakdown(amount); // small amount, see the explanation above
+
+        int n = coins.size();
+        vector<long long> result(n);
+        for (int j = 1; j < n; j++)
+            result[j] = counts[(size_t)residue * n + j];
+        result[0] = (amount - bestSum[residue]) / modulus;
+        return result;
+    }
+
+private:
+    // Follows the dense table for the few small amounts that need it (see the explanation above), extending
+    // it first if it doesn't reach `amount` yet. It at least doubles each time it grows, so a series of
+    // increasing queries costs O(n * biggest amount) in total, and it never goes past T.
+    vector<long long> denseBreakdown(long long amount)
+    {
+        long long size = denseCounts.size();
+        if (amount >= size)
+        {
+            long long newSize = min(denseLimit + 1, max(amount + 1, 2 * size));
+            denseCounts.resize(newSize, INT_MAX);
+            denseLastCoin.resize(newSize, -1);
+            if (size == 0)
+                denseCounts[0] = 0;
+            int n = coins.size();
+            for (long long i = max(size, 1LL); i < newSize; i++)
+            {
+                for (int j = 0; j < n; j++)
+                {
+                    if (i >= coins[j] && denseCounts[i - coins[j]] != INT_MAX && denseCounts[i] > denseCounts[i - coins[j]] + 1)
+                    {
+                        denseCounts[i] = denseCounts[i - coins[j]] + 1;
+                        denseLastCoin[i] = j;
+                    }
+                }
+            }
+        }
+
+        vector<long long> result(coins.size(), 0);
+        for (long long remaining = amount; remaining > 0; remaining -= coins[denseLastCoin[remaining]])
+            result[denseLastCoin[remaining]]++;
+        return result;
+    }
+
+    vector<int> coins;
+    int modulus;
+    vector<long long> minimumSum;     // per residue: smallest sum of non-L coins
+    vector<long long> cost, bestSum;  // per residue: best L*|S| - s and its sum s
+    vector<int> counts;               // per residue: n coin counts of that best S
+    long long denseLimit;             // T, the last amount that can need the dense table
+    vector<int> denseCounts;          // per amount up to the biggest small query so far (at most T): optimal count
+    vector<int> denseLastCoin;        //   and the last coin of that optimal payment
+};
+
+// Huge mode: after the coins, any number of "P Q" lines with 64-bit values
+int runHuge(vector<int> &CurrencyUnits)
+{
+    ResidueCoinChange solver(CurrencyUnits);
+    long long P, Q;
+    while (cin >> P >> Q)
+    {
+        long long change = Q - P;
+        vector<long long> result = solver.breakdown(change);
+        if (result.empty())
+            cout << "It is not possible to make change for this amount\n";
+        printCoins(result, CurrencyUnits, change);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Cash drawer: limited number of coins of each kind
+// ---------------------------------------------------------------------------
+// GreedyApproach and DymamicProgrammingApproach assume we have as many coins as we want. A real drawer has
+// stock[j] coins of CurrencyUnits[j]. Adding the coins one kind at a time, the new table is
+//     new[i] = min over 0 <= t <= stock[j] of old[i - t*c] + t          (c = CurrencyUnits[j])
+// Trying every t would cost O(stock) per amount. But amounts with the same remainder modulo c form a line
+// i = r, r + c, r + 2c, ... and with i = r + q*c the formula is
+//     new[q] = min over q - stock[j] <= p <= q of (old[p] - p) + q
+// which is the minimum of a sliding window of width stock[j] + 1. A monotone queue (a deque that keeps the
+// candidates in increasing order of old[p] - p) gives each window minimum in O(1) amortized, so every coin
+// costs O(change) and the whole table O(n * change), no matter how big the stock is.
+// Memory: the dp rows are O(change), but to give the breakdown we keep how many coins of every kind the best
+// answer for every amount uses, which is n * (change + 1) ints (4 bytes per kind per unit of change, so
+// 10 kinds and a change of 100 million need 4 GB). Amounts that big belong in --huge, which has no stock.
+
+// Returns how many coins of each kind to give (empty if the drawer can't pay `change` exactly)
+vector<int> BoundedCoinChange(int change, const vector<int> &CurrencyUnits, const vector<int> &stock)
 {
+    const int infinity = INT_MAX / 2;
+    int n = CurrencyUnits.size();
+    if (change < 0)
+        return vector<int>(); // paid less than the price: nothing to give back
+
+    vector<int> dp(change + 1, infinity), nextDp(change + 1);
+    dp[0] = 0;
+
+    // taken[j][i] = how many coins of kind j the best solution for amount i uses, using kinds 0..j
+    vector<vector<int>> taken(n, vector<int>(change + 1, 0));
+    vector<int> window(change + 1); // indices p of the monotone queue (one residue line at a time)
+
+    for (int j = 0; j < n; j++)
+    {
+        int c = CurrencyUnits[j], limit = stock[j];
+        if (c <= 0 || limit <= 0 || c > change)
+            continue; // this kind can't be used, the table stays the same
+
+        for (int r = 0; r < c && r <= change; r++)
+        {
+            int head = 0, tail = 0;
+            for (int q = 0, i = r; i <= change; q++, i += c)
+            {
+                // Add p = q to the queue, removing candidates that can never be better than it
+                if (dp[i] < infinity)
+                {
+                    while (tail > head && dp[r + window[tail - 1] * c] - window[tail - 1] >= dp[i] - q)
+                        tail--;
+                    window[tail++] = q;
+                }
+                // Drop candidates that are out of the window (more than `limit` coins back)
+                while (tail > head && window[head] < q - limit)
+                    head++;
+
+                if (tail > head)
+                {
+                    int p = window[head];
+                    nextDp[i] = dp[r + p * c] - p + q;
+                    taken[j][i] = q - p;
+                }
+                else
+                {
+                    nextDp[i] = infinity;
+                }
+            }
+        }
+        swap(dp, nextDp);
+    }
+
+    if (dp[change] >= infinity)
+        return vector<int>();
+
+    // Walk back through the kinds, from the last one added to the first
+    vector<int> result(n, 0);
+    int remaining = change;
+    for (int j = n - 1; j >= 0; j--)
+    {
+        result[j] = taken[j][remaining];
+        remaining -= result[j] * CurrencyUnits[j];
+    }
+    return result;
+}
+
+// Drawer mode: after the coins come their stock counts, then any number of "P Q" transactions.
+// Every transaction takes its change out of the drawer, so the next one sees what is left.
+int runDrawer(vector<int> &CurrencyUnits, vector<int> &stock)
+{
+    int P, Q;
+    while (cin >> P >> Q)
+    {
+        int change = Q - P;
+        vector<int> result = BoundedCoinChange(change, CurrencyUnits, stock);
+        if (result.empty())
+            cout << "It is not possible to make change for this amount with the coins in the drawer\n";
+        else
+            for (size_t j = 0; j < stock.size(); j++)
+                stock[j] -= result[j];
+        printCoins(result, CurrencyUnits, change);
+    }
+
+    cout << "\033[1;35mCoins left in the drawer: \033[0m" << endl;
+    for (size_t j = 0; j < stock.size(); j++)
+        cout << "CurrencyUnits: \033[1;32m" << CurrencyUnits[j] << "\033[0m - Coins left: \033[1;33m" << stock[j] << "\033[0m" << endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bool batch = false;
+    bool checkOnly = false;
+    bool huge = false;
+    bool vectorized = false;
+    bool drawer = false;
+    int maxAmount = 0;
+    string tablePath;
+    for (int i = 1; i < argc; i++)
+    {
+        string flag = argv[i];
+        if (flag == "--batch")
+        {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                maxAmount = atoi(argv[++i]);
+        }
+        else if (flag == "--huge")
+        {
+            huge = true;
+        }
+        else if (flag == "--vectorized")
+        {
+            vectorized = true;
+        }
+        else if (flag == "--drawer")
+        {
+            drawer = true;
+        }
+        else if (flag == "--check")
+        {
+            checkOnly = true;
+        }
+        else if (flag == "--table" && i + 1 < argc)
+        {
+            tablePath = argv[++i];
+        }
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--batch [maxAmount] [--table <file>] | --huge | --drawer | --check] [--vectorized] < in.txt" << endl;
+            return 1;
+        }
+    }
+
     int N;
     cin >> N;
     vector<int> CurrencyUnits(N);
@@ -135,12 +1008,56 @@ int main()
         cin >> CurrencyUnits[i];
     }
 
+    // In drawer mode every coin has a stock count, so sort both together
+    vector<int> stock;
+    if (drawer)
+    {
+        vector<pair<int, int>> coinsAndStock(N);
+        for (int i = 0; i < N; ++i)
+        {
+            coinsAndStock[i].first = CurrencyUnits[i];
+            cin >> coinsAndStock[i].second;
+        }
+        sort(coinsAndStock.begin(), coinsAndStock.end(), greater<pair<int, int>>());
+        for (int i = 0; i < N; ++i)
+        {
+            CurrencyUnits[i] = coinsAndStock[i].first;
+            stock.push_back(coinsAndStock[i].second);
+        }
+    }
+
+    sort(CurrencyUnits.begin(), CurrencyUnits.end(), greater<int>());
+
+    if (drawer)
+        return runDrawer(CurrencyUnits, stock);
+
+    if (checkOnly)
+    {
+        long long counterexample = findGreedyCounterexample(CurrencyUnits);
+        if (counterexample == -1)
+            cout << "The coin system is canonical: greedy is always optimal\n";
+        else if (counterexample == 0)
+            cout << "The coin system has no coin of 1: greedy can fail, the DP is needed\n";
+        else
+            cout << "The coin system is not canonical: greedy is not optimal for " << counterexample << "\n";
+        return 0;
+    }
+
+    if (huge)
+        return runHuge(CurrencyUnits);
+
+    if (batch)
+        return runBatch(CurrencyUnits, maxAmount, tablePath);
+
     int P, Q;
     cin >> P >> Q;
 
     int change = Q - P;
-
-    sort(CurrencyUnits.begin(), CurrencyUnits.end(), greater<int>());
+    if (change < 0)
+    {
+        cout << "It is not possible to make change for this amount\n";
+        return 1;
+    }
 
     cout << "\033[1;35mThis is the Greedy result: \033[0m" << endl;
 
@@ -149,7 +1066,17 @@ int main()
     printCoins(greedyResult, CurrencyUnits, change);
 
     cout << "\033[1;35mThis is the DP result: \033[0m" << endl;
-    vector<int> dpResult = DymamicProgrammingApproach(change, CurrencyUnits);
+    // For a canonical coin system greedy is already optimal, so the O(n * change) DP is skipped
+    vector<int> dpResult;
+    if (isCanonical(CurrencyUnits))
+    {
+        cerr << "Canonical coin system: using greedy instead of the DP" << endl;
+        dpResult = fastGreedy(change, CurrencyUnits);
+    }
+    else
+    {
+        dpResult = vectorized ? VectorizedDPApproach(change, CurrencyUnits) : DymamicProgrammingApproach(change, CurrencyUnits);
+    }
     printCoins(dpResult, CurrencyUnits, change);
 
     return 0;